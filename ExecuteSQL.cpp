@@ -28,6 +28,7 @@ int ExecuteSQL(const string, const string);
 //! @retval ERR_CSV_SYNTAX=8          CSVの構文解析が失敗しました。
 //! @retval ERR_MEMORY_ALLOCATE=9     メモリの取得に失敗しました。
 //! @retval ERR_MEMORY_OVER=10        用意したメモリ領域の上限を超えました。
+//! @retval ERR_BAD_PARAMETER=11      指定されたパラメータが存在しないか、パラメータに値が設定されていません。
 //! @details 
 //! 参照するテーブルは、テーブル名.csvの形で作成します。
 //! 一行目はヘッダ行で、その行に列名を書きます。
@@ -82,6 +83,12 @@ int ExecuteSQL(const string, const string);
 //! SELECT USERS.NAME, CHILDREN.NAME
 //! WHERE USERS.ID = CHILDREN.PARENTID
 //! FROM USERS, CHILDREN
+//!
+//! 例12: WHERE句には ? や :名前 でパラメータを書くことができます。値はPreparedQueryで設定します。
+//! ExecuteSQLで実行した場合は値が設定されていないので、ERR_BAD_PARAMETERとなります。
+//! SELECT *
+//! WHERE AGE >= :minAge AND NAME <> ?
+//! FROM USERS
 int ExecuteSQL(const string sql, const string outputFileName)
 {
 	try {
@@ -0,0 +1,106 @@
+#include "arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <sys/mman.h>
+
+using namespace std;
+
+//! Arenaクラスの新しいインスタンスを初期化します。
+//! @param [in] useHugePages 大きな塊にヒュージページを使うかどうかです。
+Arena::Arena(const bool useHugePages) : useHugePages(useHugePages)
+{
+}
+
+//! 確保した全ての塊を解放します。
+Arena::~Arena()
+{
+	for (auto &chunk : chunks) {
+		FreeChunk(chunk);
+	}
+}
+
+//! 塊を解放します。
+//! @param [in] chunk 解放する塊です。
+void Arena::FreeChunk(const Chunk &chunk)
+{
+	if (chunk.mapped){
+		munmap(chunk.memory, chunk.size);
+	}
+	else{
+		::operator delete(chunk.memory);
+	}
+}
+
+//! 切り出した全ての領域を破棄します。最後に確保した最も大きな塊だけを残し、以降の切り出しに再利用します。
+//! 切り出した領域を参照する配列は、呼び出す前に使い終えている必要があります。
+void Arena::Reset()
+{
+	if (chunks.empty()){
+		return;
+	}
+	for (size_t i = 0; i + 1 < chunks.size(); ++i) {
+		FreeChunk(chunks[i]);
+	}
+	chunks.erase(chunks.begin(), chunks.end() - 1);
+	cursol = chunks.back().memory;
+	end = chunks.back().memory + chunks.back().size;
+}
+
+//! 確保した塊の大きさの合計を取得します。切り出していない部分も含む、Arenaが使っているメモリの量です。
+//! @return 確保した塊の大きさの合計です。
+size_t Arena::Size() const
+{
+	size_t size = 0; // 塊の大きさの合計です。
+	for (auto &chunk : chunks) {
+		size += chunk.size;
+	}
+	return size;
+}
+
+//! 新しい塊を確保し、以降の切り出しに使います。
+//! @param [in] size 塊から切り出す必要のある最小の大きさです。
+void Arena::AddChunk(const size_t size)
+{
+	Chunk chunk = { nullptr, max(nextChunkSize, size), false };
+	nextChunkSize = min(nextChunkSize * 2, maxChunkSize);
+
+	// 大きな塊はヒュージページの大きさの倍数でmmapし、ヒュージページを使うよう指示します。指示が無視されても通常のページとして使えます。
+	if (hugePageSize <= chunk.size){
+		chunk.size = (chunk.size + hugePageSize - 1) / hugePageSize * hugePageSize;
+		auto memory = mmap(nullptr, chunk.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (memory == MAP_FAILED){
+			throw bad_alloc();
+		}
+#ifdef MADV_HUGEPAGE
+		if (useHugePages){
+			madvise(memory, chunk.size, MADV_HUGEPAGE);
+		}
+#endif
+		chunk.memory = static_cast<char*>(memory);
+		chunk.mapped = true;
+	}
+	else{
+		chunk.memory = static_cast<char*>(::operator new(chunk.size));
+	}
+	chunks.push_back(chunk);
+	cursol = chunk.memory;
+	end = chunk.memory + chunk.size;
+}
+
+//! 領域を切り出します。
+//! @param [in] size 切り出す大きさです。
+//! @param [in] alignment 切り出す領域の先頭のアラインメントです。2の累乗です。
+//! @return 切り出した領域の先頭です。
+void* Arena::Allocate(const size_t size, const size_t alignment)
+{
+	auto aligned = (reinterpret_cast<uintptr_t>(cursol) + alignment - 1) & ~(alignment - 1); // アラインメントに合わせた切り出し位置です。
+	if (!cursol || reinterpret_cast<uintptr_t>(end) < aligned + size){
+		// 塊の先頭はoperator newとmmapのどちらでも十分なアラインメントを持ちます。
+		AddChunk(size);
+		aligned = reinterpret_cast<uintptr_t>(cursol);
+	}
+	cursol = reinterpret_cast<char*>(aligned + size);
+	return reinterpret_cast<void*>(aligned);
+}
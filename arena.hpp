@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+//! 一回のクエリの実行で使うメモリを、大きな塊から切り出して割り当てる領域です。
+//! 切り出した領域は個別には解放せず、Arenaの破棄時にまとめて解放します。
+//! 大きな塊はmmapで確保し、可能であれば透過的なヒュージページを使うよう指示します。
+class Arena
+{
+	static constexpr size_t firstChunkSize = 64 * 1024;          //!< 最初に確保する塊の大きさです。
+	static constexpr size_t maxChunkSize = 64 * 1024 * 1024;     //!< 塊の大きさを倍にしていく上限です。
+	static constexpr size_t hugePageSize = 2 * 1024 * 1024;      //!< ヒュージページの大きさです。この大きさ以上の塊はmmapで確保します。
+
+	//! 確保した塊です。
+	struct Chunk {
+		char *memory;  //!< 塊の先頭です。
+		size_t size;   //!< 塊の大きさです。
+		bool mapped;   //!< mmapで確保したかどうかです。
+	};
+
+	const bool useHugePages;           //!< 大きな塊にヒュージページを使うかどうかです。
+	std::vector<Chunk> chunks;         //!< 確保した塊です。
+	char *cursol = nullptr;            //!< 最後の塊の、次に切り出す位置です。
+	char *end = nullptr;               //!< 最後の塊の終端です。
+	size_t nextChunkSize = firstChunkSize; //!< 次に確保する塊の大きさです。
+
+	//! 新しい塊を確保し、以降の切り出しに使います。
+	//! @param [in] size 塊から切り出す必要のある最小の大きさです。
+	void AddChunk(const size_t size);
+
+	//! 塊を解放します。
+	//! @param [in] chunk 解放する塊です。
+	static void FreeChunk(const Chunk &chunk);
+
+public:
+	//! Arenaクラスの新しいインスタンスを初期化します。
+	//! @param [in] useHugePages 大きな塊にヒュージページを使うかどうかです。
+	explicit Arena(const bool useHugePages = true);
+
+	//! 確保した全ての塊を解放します。
+	~Arena();
+
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	//! 切り出した全ての領域を破棄します。最後に確保した最も大きな塊だけを残し、以降の切り出しに再利用します。
+	//! 切り出した領域を参照する配列は、呼び出す前に使い終えている必要があります。
+	void Reset();
+
+	//! 確保した塊の大きさの合計を取得します。切り出していない部分も含む、Arenaが使っているメモリの量です。
+	//! @return 確保した塊の大きさの合計です。
+	size_t Size() const;
+
+	//! 領域を切り出します。
+	//! @param [in] size 切り出す大きさです。
+	//! @param [in] alignment 切り出す領域の先頭のアラインメントです。2の累乗です。
+	//! @return 切り出した領域の先頭です。
+	void* Allocate(const size_t size, const size_t alignment);
+};
+
+//! Arenaから領域を切り出す、標準コンテナ用のアロケータです。
+//! deallocateは何もせず、領域はArenaの破棄時にまとめて解放されます。
+template <typename T>
+class ArenaAllocator
+{
+public:
+	typedef T value_type; //!< 割り当てる値の型です。
+
+	Arena *arena; //!< 領域を切り出すArenaです。
+
+	//! ArenaAllocatorクラスの新しいインスタンスを初期化します。
+	//! @param [in] arena 領域を切り出すArenaです。
+	ArenaAllocator(Arena &arena) : arena(&arena) {}
+
+	//! 他の型のArenaAllocatorと同じArenaを使うインスタンスを初期化します。
+	//! @param [in] other 同じArenaを使うアロケータです。
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+	//! 値の配列の領域を切り出します。
+	//! @param [in] n 値の数です。
+	//! @return 切り出した領域の先頭です。
+	T* allocate(const size_t n) { return static_cast<T*>(arena->Allocate(n * sizeof(T), alignof(T))); }
+
+	//! 何もしません。領域はArenaの破棄時にまとめて解放されます。
+	void deallocate(T*, const size_t) {}
+
+	template <typename U>
+	bool operator==(const ArenaAllocator<U> &other) const { return arena == other.arena; }
+
+	template <typename U>
+	bool operator!=(const ArenaAllocator<U> &other) const { return arena != other.arena; }
+};
+
+//! Arenaから領域を切り出す配列です。
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
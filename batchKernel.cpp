@@ -0,0 +1,229 @@
+#include "batchKernel.hpp"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+#if defined(__SSE2__)
+	const int intsPerBlock = 4;   //!< 一度に計算する整数の数です。
+	const int bytesPerBlock = 16; //!< 一度に計算する真偽値の数です。
+
+	__m128i Load(const void *p) { return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+	void Store(void *p, const __m128i value) { _mm_storeu_si128(static_cast<__m128i*>(p), value); }
+	__m128i Not(const __m128i a) { return _mm_xor_si128(a, _mm_set1_epi32(-1)); }
+
+	//! 32ビット整数同士を掛け、下位32ビットを求めます。
+	__m128i MultiplyLow(const __m128i a, const __m128i b)
+	{
+#if defined(__SSE4_1__)
+		return _mm_mullo_epi32(a, b);
+#else
+		// SSE2には32ビット整数の掛け算がないので、偶数番目と奇数番目の要素を64ビットの掛け算で求めて組み合わせます。
+		auto even = _mm_mul_epu32(a, b);
+		auto odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+	}
+#endif
+
+	//! 整数を比較します。
+	//! @param [in] left 左のオペランドの配列です。
+	//! @param [in] right 右のオペランドの配列です。
+	//! @param [out] result 比較結果を書き込む配列です。
+	//! @param [in] count 要素の数です。
+	//! @param [in] match 四つの整数を比較し、条件に合う要素の全ビットが立ったマスクを返す関数です。
+	//! @param [in] scalar 一つの整数を比較する関数です。
+	template <typename Match, typename Scalar>
+	void Compare(const int *left, const int *right, unsigned char *result, const int count, const Match match, const Scalar scalar)
+	{
+		int i = 0;
+#if defined(__SSE2__)
+		// 十六個の整数の比較結果を、飽和させながら十六個のバイトに詰めます。
+		for (; i + bytesPerBlock <= count; i += bytesPerBlock) {
+			auto words0 = _mm_packs_epi32(match(Load(left + i), Load(right + i)), match(Load(left + i + 4), Load(right + i + 4)));
+			auto words1 = _mm_packs_epi32(match(Load(left + i + 8), Load(right + i + 8)), match(Load(left + i + 12), Load(right + i + 12)));
+			Store(result + i, _mm_and_si128(_mm_packs_epi16(words0, words1), _mm_set1_epi8(1)));
+		}
+#endif
+		for (; i < count; ++i) {
+			result[i] = scalar(left[i], right[i]);
+		}
+	}
+
+	//! 整数を計算します。
+	//! @param [in] left 左のオペランドの配列です。
+	//! @param [in] right 右のオペランドの配列です。
+	//! @param [out] result 計算結果を書き込む配列です。
+	//! @param [in] count 要素の数です。
+	//! @param [in] block 四つの整数を計算する関数です。
+	//! @param [in] scalar 一つの整数を計算する関数です。
+	template <typename Block, typename Scalar>
+	void Calculate(const int *left, const int *right, int *result, const int count, const Block block, const Scalar scalar)
+	{
+		int i = 0;
+#if defined(__SSE2__)
+		for (; i + intsPerBlock <= count; i += intsPerBlock) {
+			Store(result + i, block(Load(left + i), Load(right + i)));
+		}
+#endif
+		for (; i < count; ++i) {
+			result[i] = scalar(left[i], right[i]);
+		}
+	}
+
+	//! 真偽値を計算します。
+	//! @param [in] left 左のオペランドの配列です。
+	//! @param [in] right 右のオペランドの配列です。
+	//! @param [out] result 計算結果を書き込む配列です。
+	//! @param [in] count 要素の数です。
+	//! @param [in] block 十六個の真偽値を計算する関数です。
+	//! @param [in] scalar 一つの真偽値を計算する関数です。
+	template <typename Block, typename Scalar>
+	void Logical(const unsigned char *left, const unsigned char *right, unsigned char *result, const int count, const Block block, const Scalar scalar)
+	{
+		int i = 0;
+#if defined(__SSE2__)
+		for (; i + bytesPerBlock <= count; i += bytesPerBlock) {
+			Store(result + i, block(Load(left + i), Load(right + i)));
+		}
+#endif
+		for (; i < count; ++i) {
+			result[i] = scalar(left[i], right[i]);
+		}
+	}
+}
+
+//! 整数を＝で比較します。
+void BatchKernel::Equal(const int *left, const int *right, unsigned char *result, const int count)
+{
+#if defined(__SSE2__)
+	Compare(left, right, result, count, [](const __m128i l, const __m128i r) { return _mm_cmpeq_epi32(l, r); }, [](const int l, const int r) { return l == r; });
+#else
+	Compare(left, right, result, count, nullptr, [](const int l, const int r) { return l == r; });
+#endif
+}
+
+//! 整数を＜＞で比較します。
+void BatchKernel::NotEqual(const int *left, const int *right, unsigned char *result, const int count)
+{
+#if defined(__SSE2__)
+	Compare(left, right, result, count, [](const __m128i l, const __m128i r) { return Not(_mm_cmpeq_epi32(l, r)); }, [](const int l, const int r) { return l != r; });
+#else
+	Compare(left, right, result, count, nullptr, [](const int l, const int r) { return l != r; });
+#endif
+}
+
+//! 整数を＞で比較します。
+void BatchKernel::GreaterThan(const int *left, const int *right, unsigned char *result, const int count)
+{
+#if defined(__SSE2__)
+	Compare(left, right, result, count, [](const __m128i l, const __m128i r) { return _mm_cmpgt_epi32(l, r); }, [](const int l, const int r) { return l > r; });
+#else
+	Compare(left, right, result, count, nullptr, [](const int l, const int r) { return l > r; });
+#endif
+}
+
+//! 整数を＞＝で比較します。
+void BatchKernel::GreaterThanOrEqual(const int *left, const int *right, unsigned char *result, const int count)
+{
+#if defined(__SSE2__)
+	Compare(left, right, result, count, [](const __m128i l, const __m128i r) { return Not(_mm_cmpgt_epi32(r, l)); }, [](const int l, const int r) { return l >= r; });
+#else
+	Compare(left, right, result, count, nullptr, [](const int l, const int r) { return l >= r; });
+#endif
+}
+
+//! 整数を＜で比較します。
+void BatchKernel::LessThan(const int *left, const int *right, unsigned char *result, const int count)
+{
+#if defined(__SSE2__)
+	Compare(left, right, result, count, [](const __m128i l, const __m128i r) { return _mm_cmpgt_epi32(r, l); }, [](const int l, const int r) { return l < r; });
+#else
+	Compare(left, right, result, count, nullptr, [](const int l, const int r) { return l < r; });
+#endif
+}
+
+//! 整数を＜＝で比較します。
+void BatchKernel::LessThanOrEqual(const int *left, const int *right, unsigned char *result, const int count)
+{
+#if defined(__SSE2__)
+	Compare(left, right, result, count, [](const __m128i l, const __m128i r) { return Not(_mm_cmpgt_epi32(l, r)); }, [](const int l, const int r) { return l <= r; });
+#else
+	Compare(left, right, result, count, nullptr, [](const int l, const int r) { return l <= r; });
+#endif
+}
+
+//! 整数を足します。
+void BatchKernel::Add(const int *left, const int *right, int *result, const int count)
+{
+#if defined(__SSE2__)
+	Calculate(left, right, result, count, [](const __m128i l, const __m128i r) { return _mm_add_epi32(l, r); }, [](const int l, const int r) { return l + r; });
+#else
+	Calculate(left, right, result, count, nullptr, [](const int l, const int r) { return l + r; });
+#endif
+}
+
+//! 整数を引きます。
+void BatchKernel::Subtract(const int *left, const int *right, int *result, const int count)
+{
+#if defined(__SSE2__)
+	Calculate(left, right, result, count, [](const __m128i l, const __m128i r) { return _mm_sub_epi32(l, r); }, [](const int l, const int r) { return l - r; });
+#else
+	Calculate(left, right, result, count, nullptr, [](const int l, const int r) { return l - r; });
+#endif
+}
+
+//! 整数を掛けます。
+void BatchKernel::Multiply(const int *left, const int *right, int *result, const int count)
+{
+#if defined(__SSE2__)
+	Calculate(left, right, result, count, MultiplyLow, [](const int l, const int r) { return l * r; });
+#else
+	Calculate(left, right, result, count, nullptr, [](const int l, const int r) { return l * r; });
+#endif
+}
+
+//! 整数を割ります。SIMDには整数の割り算がないので、一つずつ計算します。
+void BatchKernel::Divide(const int *left, const int *right, int *result, const int count)
+{
+	for (int i = 0; i < count; ++i) {
+		result[i] = left[i] / right[i];
+	}
+}
+
+//! 真偽値の論理積を求めます。
+void BatchKernel::And(const unsigned char *left, const unsigned char *right, unsigned char *result, const int count)
+{
+#if defined(__SSE2__)
+	Logical(left, right, result, count, [](const __m128i l, const __m128i r) { return _mm_and_si128(l, r); }, [](const unsigned char l, const unsigned char r) { return l & r; });
+#else
+	Logical(left, right, result, count, nullptr, [](const unsigned char l, const unsigned char r) { return l & r; });
+#endif
+}
+
+//! 真偽値の論理和を求めます。
+void BatchKernel::Or(const unsigned char *left, const unsigned char *right, unsigned char *result, const int count)
+{
+#if defined(__SSE2__)
+	Logical(left, right, result, count, [](const __m128i l, const __m128i r) { return _mm_or_si128(l, r); }, [](const unsigned char l, const unsigned char r) { return l | r; });
+#else
+	Logical(left, right, result, count, nullptr, [](const unsigned char l, const unsigned char r) { return l | r; });
+#endif
+}
+
+//! 真となった要素のインデックスを並べた選択ベクトルを作成します。
+//! 分岐の予測が外れないように、全ての要素のインデックスを書き込み、真の場合だけ書き込み位置を進めます。
+//! @param [in] mask 真偽値の配列です。
+//! @param [in] count 要素の数です。
+//! @param [out] selection 真となった要素のインデックスを、昇順に書き込む配列です。count個の領域が必要です。
+//! @return 真となった要素の数です。
+int BatchKernel::Select(const unsigned char *mask, const int count, int *selection)
+{
+	int selected = 0;
+	for (int i = 0; i < count; ++i) {
+		selection[selected] = i;
+		selected += mask[i];
+	}
+	return selected;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+//! WHERE句の一度にまとめて評価する行の値の配列に対し、演算を行う機能を提供します。
+//! SSE2が使える場合は複数の値をまとめて計算し、使えない場合は一つずつ計算します。
+//! 真偽値は一要素一バイトの配列で表し、真は1、偽は0とします。
+class BatchKernel
+{
+public:
+	//! 整数を＝で比較します。
+	//! @param [in] left 左のオペランドの配列です。
+	//! @param [in] right 右のオペランドの配列です。
+	//! @param [out] result 比較結果を書き込む配列です。
+	//! @param [in] count 要素の数です。
+	static void Equal(const int *left, const int *right, unsigned char *result, const int count);
+
+	//! 整数を＜＞で比較します。
+	//! @param [in] left 左のオペランドの配列です。
+	//! @param [in] right 右のオペランドの配列です。
+	//! @param [out] result 比較結果を書き込む配列です。
+	//! @param [in] count 要素の数です。
+	static void NotEqual(const int *left, const int *right, unsigned char *result, const int count);
+
+	//! 整数を＞で比較します。
+	//! @param [in] left 左のオペランドの配列です。
+	//! @param [in] right 右のオペランドの配列です。
+	//! @param [out] result 比較結果を書き込む配列です。
+	//! @param [in] count 要素の数です。
+	static void GreaterThan(const int *left, const int *right, unsigned char *result, const int count);
+
+	//! 整数を＞＝で比較します。
+	//! @param [in] left 左のオペランドの配列です。
+	//! @param [in] right 右のオペランドの配列です。
+	//! @param [out] result 比較結果を書き込む配列です。
+	//! @param [in] count 要素の数です。
+	static void GreaterThanOrEqual(const int *left, const int *right, unsigned char *result, const int count);
+
+	//! 整数を＜で比較します。
+	//! @param [in] left 左のオペランドの配列です。
+	//! @param [in] right 右のオペランドの配列です。
+	//! @param [out] result 比較結果を書き込む配列です。
+	//! @param [in] count 要素の数です。
+	static void LessThan(const int *left, const int *right, unsigned char *result, const int count);
+
+	//! 整数を＜＝で比較します。
+	//! @param [in] left 左のオペランドの配列です。
+	//! @param [in] right 右のオペランドの配列です。
+	//! @param [out] result 比較結果を書き込む配列です。
+	//! @param [in] count 要素の数です。
+	static void LessThanOrEqual(const int *left, const int *right, unsigned char *result, const int count);
+
+	//! 整数を足します。
+	//! @param [in] left 左のオペランドの配列です。
+	//! @param [in] right 右のオペランドの配列です。
+	//! @param [out] result 計算結果を書き込む配列です。オペランドと同じ配列でも構いません。
+	//! @param [in] count 要素の数です。
+	static void Add(const int *left, const int *right, int *result, const int count);
+
+	//! 整数を引きます。
+	//! @param [in] left 左のオペランドの配列です。
+	//! @param [in] right 右のオペランドの配列です。
+	//! @param [out] result 計算結果を書き込む配列です。オペランドと同じ配列でも構いません。
+	//! @param [in] count 要素の数です。
+	static void Subtract(const int *left, const int *right, int *result, const int count);
+
+	//! 整数を掛けます。
+	//! @param [in] left 左のオペランドの配列です。
+	//! @param [in] right 右のオペランドの配列です。
+	//! @param [out] result 計算結果を書き込む配列です。オペランドと同じ配列でも構いません。
+	//! @param [in] count 要素の数です。
+	static void Multiply(const int *left, const int *right, int *result, const int count);
+
+	//! 整数を割ります。SIMDには整数の割り算がないので、一つずつ計算します。
+	//! @param [in] left 左のオペランドの配列です。
+	//! @param [in] right 右のオペランドの配列です。
+	//! @param [out] result 計算結果を書き込む配列です。オペランドと同じ配列でも構いません。
+	//! @param [in] count 要素の数です。
+	static void Divide(const int *left, const int *right, int *result, const int count);
+
+	//! 真偽値の論理積を求めます。
+	//! @param [in] left 左のオペランドの配列です。
+	//! @param [in] right 右のオペランドの配列です。
+	//! @param [out] result 計算結果を書き込む配列です。オペランドと同じ配列でも構いません。
+	//! @param [in] count 要素の数です。
+	static void And(const unsigned char *left, const unsigned char *right, unsigned char *result, const int count);
+
+	//! 真偽値の論理和を求めます。
+	//! @param [in] left 左のオペランドの配列です。
+	//! @param [in] right 右のオペランドの配列です。
+	//! @param [out] result 計算結果を書き込む配列です。オペランドと同じ配列でも構いません。
+	//! @param [in] count 要素の数です。
+	static void Or(const unsigned char *left, const unsigned char *right, unsigned char *result, const int count);
+
+	//! 真となった要素のインデックスを並べた選択ベクトルを作成します。
+	//! @param [in] mask 真偽値の配列です。
+	//! @param [in] count 要素の数です。
+	//! @param [out] selection 真となった要素のインデックスを、昇順に書き込む配列です。count個の領域が必要です。
+	//! @return 真となった要素の数です。
+	static int Select(const unsigned char *mask, const int count, int *selection);
+};
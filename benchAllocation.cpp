@@ -0,0 +1,97 @@
+//! @file
+//! クエリの実行中に行われるメモリ確保の回数を測定するベンチマークです。
+//! グローバルなoperator newを置き換えて確保の回数とバイト数を数え、SQLの解析と実行のそれぞれについて出力します。
+//! Arenaがmmapで確保する大きな塊はoperator newを通らないので数えません。
+
+#include "ExecuteSQL.hpp"
+#include "sqlQuery.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+using namespace std;
+
+namespace {
+	atomic<size_t> allocationCount(0); //!< operator newが呼ばれた回数です。
+	atomic<size_t> allocationBytes(0); //!< operator newで確保したバイト数の合計です。
+
+	//! 測定に使うCSVファイルを作成します。整数の列と、短い文字列と長い文字列の列を持ちます。
+	//! @param [in] rows データ行の数です。
+	void MakeTable(const int rows)
+	{
+		ofstream o("ALLOCATION.csv");
+		o << "Id,Age,Status,Comment" << "\n";
+		for (int i = 0; i < rows; ++i) {
+			o << i << "," << i % 90 << ",STATUS" << i % 7 << ",COMMENT TEXT LONGER THAN TWELVE BYTES " << i % 1000 << "\n";
+		}
+	}
+
+	//! 処理を実行し、その間のメモリ確保の回数とバイト数、時間を出力します。
+	//! @param [in] name 出力する処理の名前です。
+	//! @param [in] body 測定する処理です。
+	template <typename Body>
+	void Measure(const string name, const Body body)
+	{
+		auto count = allocationCount.load();
+		auto bytes = allocationBytes.load();
+		auto start = chrono::steady_clock::now();
+		body();
+		chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+		cout << left << setw(24) << name << right
+			<< setw(12) << allocationCount.load() - count << " allocations"
+			<< setw(14) << allocationBytes.load() - bytes << " bytes"
+			<< setw(10) << fixed << setprecision(1) << elapsed.count() << " ms" << endl;
+	}
+}
+
+//! 確保の回数とバイト数を数えてからメモリを確保します。
+void* operator new(size_t size)
+{
+	++allocationCount;
+	allocationBytes += size;
+	if (auto p = malloc(size ? size : 1)) {
+		return p;
+	}
+	throw bad_alloc();
+}
+
+//! operator newで確保したメモリを解放します。
+void operator delete(void *p) noexcept
+{
+	free(p);
+}
+
+//! operator newで確保したメモリを解放します。
+void operator delete(void *p, size_t) noexcept
+{
+	free(p);
+}
+
+int main()
+{
+	const int rows = 200000; // 測定に使うテーブルの行数です。
+	MakeTable(rows);
+	cout << "ALLOCATION.csv " << rows << " rows" << endl;
+
+	const string sql =
+		"SELECT Id, Status, Comment "
+		"WHERE Age >= 30 AND Age < 32 AND Status <> 'STATUS3' "
+		"ORDER BY Id DESC "
+		"FROM ALLOCATION";
+
+	Measure("parse (first)", [&]() { SqlQuery query(sql); });
+	Measure("parse (cached)", [&]() { SqlQuery query(sql); });
+
+	SqlQuery query(sql);
+	for (int i = 0; i < 2; ++i) {
+		Measure("execute", [&]() { query.Execute("ALLOCATION_OUTPUT.csv"); });
+	}
+	Measure("ExecuteSQL", [&]() { ExecuteSQL(sql, "ALLOCATION_OUTPUT.csv"); });
+	return 0;
+}
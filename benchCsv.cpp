@@ -0,0 +1,175 @@
+//! @file
+//! CSVの列と行の区切りを求める速度を測定するベンチマークです。
+//! 指定した大きさ(MB、省略時は1024)のCSVファイルを作成し、以前の実装のgetlineとfindによる区切り、マッピングしたファイルのmemchrによる区切り、CsvScannerの各実装で求めたビットマスクによる区切りの時間を出力します。
+
+#include "csvScanner.hpp"
+#include "mappedFile.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+namespace {
+	const char *path = "BENCHCSV.csv"; //!< 測定に使うCSVファイルのパスです。
+
+	//! 測定に使うCSVファイルを作成します。数値の列、短い文字列の列、長い文字列の列を持ちます。
+	//! @param [in] bytes 作成するファイルのおおよそのバイト数です。
+	//! @return 作成したファイルのバイト数です。
+	size_t MakeCsv(const size_t bytes)
+	{
+		ofstream o(path);
+		o << "Id,Code,Name,Comment\n";
+		string line;
+		size_t written = 0;
+		for (int i = 0; written < bytes; ++i) {
+			line = to_string(i) + ",C" + to_string(i % 97) + ",NAME" + to_string(i % 1009) + ",comment for the row number " + to_string(i) + " in the benchmark\n";
+			o << line;
+			written += line.size();
+		}
+		return written;
+	}
+
+	//! 区切った値の数と長さの合計です。実装の結果が一致することの確認と、最適化で処理が消えないように使います。
+	struct Count
+	{
+		size_t cells = 0;  //!< 値の数です。
+		size_t bytes = 0;  //!< 値の長さの合計です。
+		size_t lines = 0;  //!< 行の数です。
+	};
+
+	//! 以前の実装と同じように、getlineで行を読み、findでカンマを探して区切ります。
+	//! @return 区切った値の数と長さの合計です。
+	Count SplitByGetline()
+	{
+		Count count;
+		ifstream input(path);
+		string line;
+		while (getline(input, line)) {
+			auto cursol = line.begin();
+			while (cursol != line.end()) {
+				auto start = cursol;
+				cursol = find(cursol, line.end(), ',');
+				++count.cells;
+				count.bytes += cursol - start;
+				if (cursol != line.end()) {
+					++cursol;
+				}
+			}
+			++count.lines;
+		}
+		return count;
+	}
+
+	//! マッピングしたファイルを、memchrで改行文字とカンマを探して区切ります。
+	//! @return 区切った値の数と長さの合計です。
+	Count SplitByMemchr()
+	{
+		Count count;
+		MappedFile file(path);
+		auto contents = file.Contents();
+		auto cursol = contents.data();
+		auto end = contents.data() + contents.size();
+		while (cursol != end) {
+			auto newLine = static_cast<const char*>(memchr(cursol, '\n', end - cursol));
+			auto lineEnd = newLine ? newLine : end;
+			while (cursol != lineEnd) {
+				auto start = cursol;
+				auto comma = static_cast<const char*>(memchr(cursol, ',', lineEnd - cursol));
+				cursol = comma ? comma : lineEnd;
+				++count.cells;
+				count.bytes += cursol - start;
+				if (cursol != lineEnd) {
+					++cursol;
+				}
+			}
+			cursol = newLine ? newLine + 1 : end;
+			++count.lines;
+		}
+		return count;
+	}
+
+	//! マッピングしたファイルを、ビットマスクで求めたカンマと改行文字の位置で区切ります。
+	//! @param [in] scan ビットマスクを求める実装です。
+	//! @return 区切った値の数と長さの合計です。
+	Count SplitByMasks(CsvScanner::Masks (*scan)(const char*))
+	{
+		Count count;
+		MappedFile file(path);
+		auto contents = file.Contents();
+		auto end = contents.data() + contents.size();
+		auto lineStart = contents.data();
+		auto columnStart = contents.data();
+		for (auto blockStart = contents.data(); blockStart < end; blockStart += CsvScanner::blockSize) {
+			CsvScanner::Masks masks;
+			if (end - blockStart >= CsvScanner::blockSize) {
+				masks = scan(blockStart);
+			}
+			else {
+				char tail[CsvScanner::blockSize] = {};
+				memcpy(tail, blockStart, end - blockStart);
+				masks = scan(tail);
+			}
+			for (auto structurals = masks.commas | masks.newLines; structurals; structurals &= structurals - 1) {
+				auto position = blockStart + __builtin_ctzll(structurals);
+				++count.cells;
+				count.bytes += position - columnStart;
+				columnStart = position + 1;
+				if (masks.newLines & (structurals & -structurals)) {
+					lineStart = columnStart;
+					++count.lines;
+				}
+			}
+		}
+		if (lineStart != end) {
+			++count.cells;
+			count.bytes += end - columnStart;
+			++count.lines;
+		}
+		return count;
+	}
+
+	//! 処理を実行し、時間を出力します。
+	//! @param [in] name 出力する処理の名前です。
+	//! @param [in] bytes 処理で読むバイト数です。
+	//! @param [in] body 測定する処理です。
+	void Measure(const string name, const size_t bytes, const function<Count()> &body)
+	{
+		auto start = chrono::steady_clock::now();
+		auto count = body();
+		chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+		cout << left << setw(28) << name << right << setw(10) << fixed << setprecision(1) << elapsed.count() << " ms"
+			<< setw(10) << setprecision(0) << bytes / 1000.0 / elapsed.count() << " MB/s"
+			<< "   (" << count.lines << " lines, " << count.cells << " cells, " << count.bytes << " bytes)" << endl;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	size_t megaBytes = argc > 1 ? stoul(argv[1]) : 1024; // 作成するファイルのおおよその大きさ(MB)です。
+	auto bytes = MakeCsv(megaBytes * 1024 * 1024);
+	cout << "CSV " << bytes << " bytes" << endl;
+
+	// 最初の測定だけがファイルをディスクから読まないように、一度読んでおきます。
+	SplitByMemchr();
+
+	Measure("getline + find", bytes, SplitByGetline);
+	Measure("mmap + memchr", bytes, SplitByMemchr);
+	Measure("bitmask: scalar", bytes, []() { return SplitByMasks(CsvScanner::ScanScalar); });
+	Measure("bitmask: sse2", bytes, []() { return SplitByMasks(CsvScanner::ScanSse2); });
+	if (CsvScanner::SupportsAvx2()) {
+		Measure("bitmask: avx2", bytes, []() { return SplitByMasks(CsvScanner::ScanAvx2); });
+	}
+	Measure("bitmask: CsvScanner::Scan", bytes, []() { return SplitByMasks(CsvScanner::Scan); });
+
+	remove(path);
+	return 0;
+}
@@ -0,0 +1,137 @@
+//! @file
+//! 字句解析の速度を測定するマイクロベンチマークです。
+//! 数キロバイトのSQLに対し、文字種別の読み飛ばしを文字列検索、一文字ずつの表引き、SIMDの各実装で行った時間と、字句解析全体の時間を出力します。
+
+#include "lexer.hpp"
+#include "charScanner.hpp"
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	const string space = " \t\r\n"; //!< 以前の実装で使っていた全ての空白文字です。
+	const string num = "0123456789"; //!< 以前の実装で使っていた全ての数字です。
+	const string alpahNumUnder = "_abcdefghijklmnopqrstuvwxzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"; //!< 以前の実装で使っていた識別子の文字です。
+
+	//! 測定に使うSQLを作成します。長い識別子と多数のOR条件を含むWHERE句を持ちます。
+	//! @param [in] terms WHERE句のOR条件の数です。
+	//! @return 作成したSQLです。
+	string MakeSql(const int terms)
+	{
+		string sql = "SELECT    CUSTOMER_IDENTIFIER_NUMBER,   CUSTOMER_DISPLAY_NAME_FOR_REPORT\n  WHERE ";
+		for (int i = 0; i < terms; ++i) {
+			if (i) {
+				sql += "\n     OR ";
+			}
+			sql += "CUSTOMER_IDENTIFIER_NUMBER   =   " + to_string(1234567890 - i) + "   AND   CUSTOMER_REGION_NAME = 'REGION NAME " + to_string(i) + "'";
+		}
+		sql += "\n  FROM CUSTOMER_MASTER_TABLE";
+		return sql;
+	}
+
+	//! 字句解析器と同じように、文字種別の並びが始まる位置でだけ読み飛ばし関数を呼び、SQL全体を読みます。
+	//! @param [in] sql 読むSQLです。
+	//! @param [in] isStart 文字種別の並びが始まる文字かどうかを調べる関数です。
+	//! @param [in] skip 並びの二文字目以降を読み飛ばす関数です。
+	//! @return 読み飛ばした文字数の合計です。最適化で処理が消えないように使います。
+	template <typename IsStart, typename Skip>
+	size_t ScanAll(const string &sql, const IsStart isStart, const Skip skip)
+	{
+		size_t total = 0;
+		auto cursol = sql.data();
+		auto end = sql.data() + sql.size();
+		while (cursol != end) {
+			if (isStart(*cursol)) {
+				auto next = skip(cursol + 1, end);
+				total += next - cursol;
+				cursol = next;
+			}
+			else {
+				++cursol;
+			}
+		}
+		return total;
+	}
+
+	//! 文字種別の並びが始まる文字かどうかを、どの実装でも同じ速さで調べるための表です。
+	struct StartTable {
+		bool table[256] = {};
+		StartTable(const string chars) { for (auto c : chars) { table[static_cast<unsigned char>(c)] = true; } }
+		bool operator()(const char c) const { return table[static_cast<unsigned char>(c)]; }
+	};
+	const StartTable IsSpace(space);
+	const StartTable IsDigit(num);
+	const StartTable IsIdentifierPart(alpahNumUnder);
+	const StartTable IsQuote("\'");
+
+	//! 処理を繰り返し実行し、一回あたりの時間を出力します。
+	//! @param [in] name 出力する処理の名前です。
+	//! @param [in] bytes 一回の処理で読むバイト数です。
+	//! @param [in] body 測定する処理です。
+	void Measure(const string name, const size_t bytes, const function<size_t()> &body)
+	{
+		const int repeat = 200; // 処理を繰り返す回数です。
+		size_t check = 0; // 最適化で処理が消えないように使う値です。
+		auto start = chrono::steady_clock::now();
+		for (int i = 0; i < repeat; ++i) {
+			check += body();
+		}
+		chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - start;
+		auto perRun = elapsed.count() / repeat;
+		cout << left << setw(36) << name << right << setw(10) << fixed << setprecision(1) << perRun << " us"
+			<< setw(10) << setprecision(0) << bytes / perRun << " MB/s" << "   (" << check % 10 << ")" << endl;
+	}
+}
+
+int main()
+{
+	for (int terms : { 50, 500 }) {
+		auto sql = MakeSql(terms);
+		cout << "SQL " << sql.size() << " bytes" << endl;
+
+		Measure("spaces: string::find", sql.size(), [&]() {
+			return ScanAll(sql, IsSpace, [](const char *cursol, const char *end) {
+				while (cursol != end && space.find(*cursol) != string::npos) { ++cursol; }
+				return cursol;
+			});
+		});
+		Measure("spaces: scalar", sql.size(), [&]() { return ScanAll(sql, IsSpace, CharScanner::SkipSpacesScalar); });
+		Measure("spaces: simd", sql.size(), [&]() { return ScanAll(sql, IsSpace, CharScanner::SkipSpaces); });
+
+		Measure("digits: string::find", sql.size(), [&]() {
+			return ScanAll(sql, IsDigit, [](const char *cursol, const char *end) {
+				while (cursol != end && num.find(*cursol) != string::npos) { ++cursol; }
+				return cursol;
+			});
+		});
+		Measure("digits: scalar", sql.size(), [&]() { return ScanAll(sql, IsDigit, CharScanner::SkipDigitsScalar); });
+		Measure("digits: simd", sql.size(), [&]() { return ScanAll(sql, IsDigit, CharScanner::SkipDigits); });
+
+		Measure("identifier: string::find", sql.size(), [&]() {
+			return ScanAll(sql, IsIdentifierPart, [](const char *cursol, const char *end) {
+				while (cursol != end && alpahNumUnder.find(*cursol) != string::npos) { ++cursol; }
+				return cursol;
+			});
+		});
+		Measure("identifier: scalar", sql.size(), [&]() { return ScanAll(sql, IsIdentifierPart, CharScanner::SkipIdentifierPartScalar); });
+		Measure("identifier: simd", sql.size(), [&]() { return ScanAll(sql, IsIdentifierPart, CharScanner::SkipIdentifierPart); });
+
+		Measure("quote: scalar", sql.size(), [&]() { return ScanAll(sql, IsQuote, CharScanner::FindQuoteScalar); });
+		Measure("quote: simd", sql.size(), [&]() { return ScanAll(sql, IsQuote, CharScanner::FindQuote); });
+
+		vector<Token> tokens;
+		Measure("Lexer::Tokenize", sql.size(), [&]() {
+			tokens.clear();
+			Lexer::Instance().Tokenize(sql, tokens);
+			return tokens.size();
+		});
+		cout << endl;
+	}
+	return 0;
+}
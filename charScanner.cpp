@@ -0,0 +1,339 @@
+#include "charScanner.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CHAR_SCANNER_X86
+#endif
+
+namespace {
+	// メトリクス測定ツールのccccはシングルクォートの文字リテラル中のエスケープを認識しないため、文字リテラルを使わないことで回避しています。
+	const char quote = "\'"[0];
+
+	//! 空白文字かどうかを調べます。
+	bool IsSpace(const char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+	}
+
+	//! 数字かどうかを調べます。
+	bool IsDigit(const char c)
+	{
+		return '0' <= c && c <= '9';
+	}
+
+	//! 識別子の二文字目以降になれる文字かどうかを調べます。
+	bool IsIdentifierPart(const char c)
+	{
+		return IsDigit(c) || ('A' <= c && c <= 'Z') || ('a' <= c && c <= 'z' && c != 'y') || c == '_';
+	}
+
+	//! シングルクォート以外の文字かどうかを調べます。
+	bool IsNotQuote(const char c)
+	{
+		return c != quote;
+	}
+
+	//! 条件に当てはまるバイトの並びを、ブロック単位で読み飛ばします。
+	//! ブロックを調べる関数とはポインタとマスクだけをやり取りするので、AVX2の命令で生成した関数も呼び出せます。
+	//! @param [in] cursol 読み込み開始位置です。
+	//! @param [in] end 読み込み範囲の終了位置です。
+	//! @param [in] isMatch 一つのバイトが条件に当てはまるかどうかを調べる関数です。
+	//! @param [in] match ブロックの各バイトが条件に当てはまるかどうかを、ビットが立ったマスクで返す関数です。
+	//! @param [in] scalar ブロックに満たない残りを調べる関数です。
+	//! @return 最初の条件に当てはまらないバイトの位置です。
+	template <int blockSize, typename IsMatch, typename Match, typename Scalar>
+	const char* SkipBlocks(const char *cursol, const char *end, const IsMatch isMatch, const Match match, const Scalar scalar)
+	{
+		const auto fullMask = static_cast<unsigned int>((1ull << blockSize) - 1); // 全てのバイトが条件に当てはまった場合のマスクです。
+
+		// SQLでは一文字で終わる並びが多いので、最初の一文字はブロックを読まずに調べます。
+		if (cursol == end || !isMatch(*cursol)) {
+			return cursol;
+		}
+		++cursol;
+		while (end - cursol >= blockSize) {
+			auto mask = match(cursol); // 条件に当てはまるバイトのビットが立ったマスクです。
+			if (mask != fullMask) {
+				return cursol + __builtin_ctz(~mask);
+			}
+			cursol += blockSize;
+		}
+		return scalar(cursol, end);
+	}
+
+#if defined(__SSE2__)
+	//! 16バイトのブロックの各バイトが範囲内にあるかどうかを調べます。比較は符号付きで行うので、0x80以上のバイトは範囲外となります。
+	__m128i InRangeSse2(const __m128i block, const char first, const char last)
+	{
+		return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(first - 1)), _mm_cmpgt_epi8(_mm_set1_epi8(last + 1), block));
+	}
+
+	//! 16バイトのブロックから、空白文字の位置のビットが立ったマスクを求めます。
+	unsigned int SpaceMaskSse2(const char *p)
+	{
+		auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		auto space = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\t')));
+		auto newLine = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\n')));
+		return static_cast<unsigned int>(_mm_movemask_epi8(_mm_or_si128(space, newLine)));
+	}
+
+	//! 16バイトのブロックから、数字の位置のビットが立ったマスクを求めます。
+	unsigned int DigitMaskSse2(const char *p)
+	{
+		return static_cast<unsigned int>(_mm_movemask_epi8(InRangeSse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), '0', '9')));
+	}
+
+	//! 16バイトのブロックから、識別子の二文字目以降になれる文字の位置のビットが立ったマスクを求めます。
+	unsigned int IdentifierPartMaskSse2(const char *p)
+	{
+		auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		auto lower = _mm_andnot_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('y')), InRangeSse2(block, 'a', 'z'));
+		auto others = _mm_or_si128(InRangeSse2(block, '0', '9'), InRangeSse2(block, 'A', 'Z'));
+		return static_cast<unsigned int>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(others, lower), _mm_cmpeq_epi8(block, _mm_set1_epi8('_')))));
+	}
+
+	//! 16バイトのブロックから、シングルクォート以外の文字の位置のビットが立ったマスクを求めます。
+	unsigned int NotQuoteMaskSse2(const char *p)
+	{
+		auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		return static_cast<unsigned int>(_mm_movemask_epi8(_mm_andnot_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(quote)), _mm_set1_epi8(-1))));
+	}
+#endif
+
+#if defined(CHAR_SCANNER_X86)
+	// 以下の関数は、コンパイル時にAVX2を有効にしていなくてもAVX2の命令で生成します。SupportsAvx2がfalseの環境で呼んではいけません。
+
+	//! 32バイトのブロックの各バイトが範囲内にあるかどうかを調べます。比較は符号付きで行うので、0x80以上のバイトは範囲外となります。
+	__attribute__((target("avx2")))
+	__m256i InRangeAvx2(const __m256i block, const char first, const char last)
+	{
+		return _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8(first - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(last + 1), block));
+	}
+
+	//! 32バイトのブロックから、空白文字の位置のビットが立ったマスクを求めます。
+	__attribute__((target("avx2")))
+	unsigned int SpaceMaskAvx2(const char *p)
+	{
+		auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		auto space = _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\t')));
+		auto newLine = _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\r')), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n')));
+		return static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_or_si256(space, newLine)));
+	}
+
+	//! 32バイトのブロックから、数字の位置のビットが立ったマスクを求めます。
+	__attribute__((target("avx2")))
+	unsigned int DigitMaskAvx2(const char *p)
+	{
+		return static_cast<unsigned int>(_mm256_movemask_epi8(InRangeAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), '0', '9')));
+	}
+
+	//! 32バイトのブロックから、識別子の二文字目以降になれる文字の位置のビットが立ったマスクを求めます。
+	__attribute__((target("avx2")))
+	unsigned int IdentifierPartMaskAvx2(const char *p)
+	{
+		auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		auto lower = _mm256_andnot_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('y')), InRangeAvx2(block, 'a', 'z'));
+		auto others = _mm256_or_si256(InRangeAvx2(block, '0', '9'), InRangeAvx2(block, 'A', 'Z'));
+		return static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(others, lower), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('_')))));
+	}
+
+	//! 32バイトのブロックから、シングルクォート以外の文字の位置のビットが立ったマスクを求めます。
+	__attribute__((target("avx2")))
+	unsigned int NotQuoteMaskAvx2(const char *p)
+	{
+		auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		return static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_andnot_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(quote)), _mm256_set1_epi8(-1))));
+	}
+#endif
+}
+
+//! 空白文字を読み飛ばします。
+//! @param [in] cursol 読み込み開始位置です。
+//! @param [in] end 読み込み範囲の終了位置です。
+//! @return 最初の空白文字ではない文字の位置です。見つからなかった場合はendを返します。
+const char* CharScanner::SkipSpaces(const char *cursol, const char *end)
+{
+#if defined(__AVX2__)
+	return SkipSpacesAvx2(cursol, end);
+#else
+	return SkipSpacesSse2(cursol, end);
+#endif
+}
+
+//! 数字を読み飛ばします。
+//! @param [in] cursol 読み込み開始位置です。
+//! @param [in] end 読み込み範囲の終了位置です。
+//! @return 最初の数字ではない文字の位置です。見つからなかった場合はendを返します。
+const char* CharScanner::SkipDigits(const char *cursol, const char *end)
+{
+#if defined(__AVX2__)
+	return SkipDigitsAvx2(cursol, end);
+#else
+	return SkipDigitsSse2(cursol, end);
+#endif
+}
+
+//! 識別子の二文字目以降になれる文字を読み飛ばします。
+//! 字句解析器の定義に合わせ、小文字のyは識別子の文字に含みません。
+//! @param [in] cursol 読み込み開始位置です。
+//! @param [in] end 読み込み範囲の終了位置です。
+//! @return 最初の識別子の文字ではない文字の位置です。見つからなかった場合はendを返します。
+const char* CharScanner::SkipIdentifierPart(const char *cursol, const char *end)
+{
+#if defined(__AVX2__)
+	return SkipIdentifierPartAvx2(cursol, end);
+#else
+	return SkipIdentifierPartSse2(cursol, end);
+#endif
+}
+
+//! シングルクォートを検索します。
+//! @param [in] cursol 読み込み開始位置です。
+//! @param [in] end 読み込み範囲の終了位置です。
+//! @return 最初のシングルクォートの位置です。見つからなかった場合はendを返します。
+const char* CharScanner::FindQuote(const char *cursol, const char *end)
+{
+#if defined(__AVX2__)
+	return FindQuoteAvx2(cursol, end);
+#else
+	return FindQuoteSse2(cursol, end);
+#endif
+}
+
+//! 実行するCPUがAVX2に対応しているかどうかを調べます。
+//! @return AVX2に対応していればtrueです。
+bool CharScanner::SupportsAvx2()
+{
+#if defined(CHAR_SCANNER_X86)
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+//! SkipSpacesを一文字ずつ調べる実装で行います。
+const char* CharScanner::SkipSpacesScalar(const char *cursol, const char *end)
+{
+	while (cursol != end && IsSpace(*cursol)) {
+		++cursol;
+	}
+	return cursol;
+}
+
+//! SkipDigitsを一文字ずつ調べる実装で行います。
+const char* CharScanner::SkipDigitsScalar(const char *cursol, const char *end)
+{
+	while (cursol != end && IsDigit(*cursol)) {
+		++cursol;
+	}
+	return cursol;
+}
+
+//! SkipIdentifierPartを一文字ずつ調べる実装で行います。
+const char* CharScanner::SkipIdentifierPartScalar(const char *cursol, const char *end)
+{
+	while (cursol != end && IsIdentifierPart(*cursol)) {
+		++cursol;
+	}
+	return cursol;
+}
+
+//! FindQuoteを一文字ずつ調べる実装で行います。
+const char* CharScanner::FindQuoteScalar(const char *cursol, const char *end)
+{
+	while (cursol != end && *cursol != quote) {
+		++cursol;
+	}
+	return cursol;
+}
+
+//! SkipSpacesをSSE2で行います。SSE2が使えない環境ではSkipSpacesScalarで行います。
+const char* CharScanner::SkipSpacesSse2(const char *cursol, const char *end)
+{
+#if defined(__SSE2__)
+	return SkipBlocks<16>(cursol, end, IsSpace, SpaceMaskSse2, SkipSpacesScalar);
+#else
+	return SkipSpacesScalar(cursol, end);
+#endif
+}
+
+//! SkipDigitsをSSE2で行います。SSE2が使えない環境ではSkipDigitsScalarで行います。
+const char* CharScanner::SkipDigitsSse2(const char *cursol, const char *end)
+{
+#if defined(__SSE2__)
+	return SkipBlocks<16>(cursol, end, IsDigit, DigitMaskSse2, SkipDigitsScalar);
+#else
+	return SkipDigitsScalar(cursol, end);
+#endif
+}
+
+//! SkipIdentifierPartをSSE2で行います。SSE2が使えない環境ではSkipIdentifierPartScalarで行います。
+const char* CharScanner::SkipIdentifierPartSse2(const char *cursol, const char *end)
+{
+#if defined(__SSE2__)
+	return SkipBlocks<16>(cursol, end, IsIdentifierPart, IdentifierPartMaskSse2, SkipIdentifierPartScalar);
+#else
+	return SkipIdentifierPartScalar(cursol, end);
+#endif
+}
+
+//! FindQuoteをSSE2で行います。SSE2が使えない環境ではFindQuoteScalarで行います。
+const char* CharScanner::FindQuoteSse2(const char *cursol, const char *end)
+{
+#if defined(__SSE2__)
+	return SkipBlocks<16>(cursol, end, IsNotQuote, NotQuoteMaskSse2, FindQuoteScalar);
+#else
+	return FindQuoteScalar(cursol, end);
+#endif
+}
+
+#if defined(CHAR_SCANNER_X86)
+//! SkipSpacesをAVX2で行います。SupportsAvx2がfalseの環境で呼んではいけません。
+const char* CharScanner::SkipSpacesAvx2(const char *cursol, const char *end)
+{
+	return SkipBlocks<32>(cursol, end, IsSpace, SpaceMaskAvx2, SkipSpacesScalar);
+}
+
+//! SkipDigitsをAVX2で行います。SupportsAvx2がfalseの環境で呼んではいけません。
+const char* CharScanner::SkipDigitsAvx2(const char *cursol, const char *end)
+{
+	return SkipBlocks<32>(cursol, end, IsDigit, DigitMaskAvx2, SkipDigitsScalar);
+}
+
+//! SkipIdentifierPartをAVX2で行います。SupportsAvx2がfalseの環境で呼んではいけません。
+const char* CharScanner::SkipIdentifierPartAvx2(const char *cursol, const char *end)
+{
+	return SkipBlocks<32>(cursol, end, IsIdentifierPart, IdentifierPartMaskAvx2, SkipIdentifierPartScalar);
+}
+
+//! FindQuoteをAVX2で行います。SupportsAvx2がfalseの環境で呼んではいけません。
+const char* CharScanner::FindQuoteAvx2(const char *cursol, const char *end)
+{
+	return SkipBlocks<32>(cursol, end, IsNotQuote, NotQuoteMaskAvx2, FindQuoteScalar);
+}
+#else
+//! SkipSpacesをAVX2で行います。AVX2が使えない環境ではSkipSpacesSse2で行います。
+const char* CharScanner::SkipSpacesAvx2(const char *cursol, const char *end)
+{
+	return SkipSpacesSse2(cursol, end);
+}
+
+//! SkipDigitsをAVX2で行います。AVX2が使えない環境ではSkipDigitsSse2で行います。
+const char* CharScanner::SkipDigitsAvx2(const char *cursol, const char *end)
+{
+	return SkipDigitsSse2(cursol, end);
+}
+
+//! SkipIdentifierPartをAVX2で行います。AVX2が使えない環境ではSkipIdentifierPartSse2で行います。
+const char* CharScanner::SkipIdentifierPartAvx2(const char *cursol, const char *end)
+{
+	return SkipIdentifierPartSse2(cursol, end);
+}
+
+//! FindQuoteをAVX2で行います。AVX2が使えない環境ではFindQuoteSse2で行います。
+const char* CharScanner::FindQuoteAvx2(const char *cursol, const char *end)
+{
+	return FindQuoteSse2(cursol, end);
+}
+#endif
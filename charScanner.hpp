@@ -0,0 +1,74 @@
+#pragma once
+
+//! 同じ文字種別の文字の並びを読み飛ばす機能を提供します。
+//! コンパイル時にAVX2を有効にした場合は32バイトずつ、SSE2が使える場合は16バイトずつまとめて調べ、どちらも使えない場合は一文字ずつ調べます。
+//! 実装ごとの結果を比べられるように、各実装も個別に呼び出せます。
+//! 各メソッドは調べた範囲の外を読むことはありません。
+class CharScanner
+{
+public:
+	//! 空白文字を読み飛ばします。
+	//! @param [in] cursol 読み込み開始位置です。
+	//! @param [in] end 読み込み範囲の終了位置です。
+	//! @return 最初の空白文字ではない文字の位置です。見つからなかった場合はendを返します。
+	static const char* SkipSpaces(const char *cursol, const char *end);
+
+	//! 数字を読み飛ばします。
+	//! @param [in] cursol 読み込み開始位置です。
+	//! @param [in] end 読み込み範囲の終了位置です。
+	//! @return 最初の数字ではない文字の位置です。見つからなかった場合はendを返します。
+	static const char* SkipDigits(const char *cursol, const char *end);
+
+	//! 識別子の二文字目以降になれる文字を読み飛ばします。
+	//! 字句解析器の定義に合わせ、小文字のyは識別子の文字に含みません。
+	//! @param [in] cursol 読み込み開始位置です。
+	//! @param [in] end 読み込み範囲の終了位置です。
+	//! @return 最初の識別子の文字ではない文字の位置です。見つからなかった場合はendを返します。
+	static const char* SkipIdentifierPart(const char *cursol, const char *end);
+
+	//! シングルクォートを検索します。
+	//! @param [in] cursol 読み込み開始位置です。
+	//! @param [in] end 読み込み範囲の終了位置です。
+	//! @return 最初のシングルクォートの位置です。見つからなかった場合はendを返します。
+	static const char* FindQuote(const char *cursol, const char *end);
+
+	//! 実行するCPUがAVX2に対応しているかどうかを調べます。
+	//! @return AVX2に対応していればtrueです。
+	static bool SupportsAvx2();
+
+	//! SkipSpacesを一文字ずつ調べる実装で行います。
+	static const char* SkipSpacesScalar(const char *cursol, const char *end);
+
+	//! SkipDigitsを一文字ずつ調べる実装で行います。
+	static const char* SkipDigitsScalar(const char *cursol, const char *end);
+
+	//! SkipIdentifierPartを一文字ずつ調べる実装で行います。
+	static const char* SkipIdentifierPartScalar(const char *cursol, const char *end);
+
+	//! FindQuoteを一文字ずつ調べる実装で行います。
+	static const char* FindQuoteScalar(const char *cursol, const char *end);
+
+	//! SkipSpacesをSSE2で行います。SSE2が使えない環境ではSkipSpacesScalarで行います。
+	static const char* SkipSpacesSse2(const char *cursol, const char *end);
+
+	//! SkipDigitsをSSE2で行います。SSE2が使えない環境ではSkipDigitsScalarで行います。
+	static const char* SkipDigitsSse2(const char *cursol, const char *end);
+
+	//! SkipIdentifierPartをSSE2で行います。SSE2が使えない環境ではSkipIdentifierPartScalarで行います。
+	static const char* SkipIdentifierPartSse2(const char *cursol, const char *end);
+
+	//! FindQuoteをSSE2で行います。SSE2が使えない環境ではFindQuoteScalarで行います。
+	static const char* FindQuoteSse2(const char *cursol, const char *end);
+
+	//! SkipSpacesをAVX2で行います。SupportsAvx2がfalseの環境で呼んではいけません。AVX2が使えない環境ではSkipSpacesSse2で行います。
+	static const char* SkipSpacesAvx2(const char *cursol, const char *end);
+
+	//! SkipDigitsをAVX2で行います。SupportsAvx2がfalseの環境で呼んではいけません。AVX2が使えない環境ではSkipDigitsSse2で行います。
+	static const char* SkipDigitsAvx2(const char *cursol, const char *end);
+
+	//! SkipIdentifierPartをAVX2で行います。SupportsAvx2がfalseの環境で呼んではいけません。AVX2が使えない環境ではSkipIdentifierPartSse2で行います。
+	static const char* SkipIdentifierPartAvx2(const char *cursol, const char *end);
+
+	//! FindQuoteをAVX2で行います。SupportsAvx2がfalseの環境で呼んではいけません。AVX2が使えない環境ではFindQuoteSse2で行います。
+	static const char* FindQuoteAvx2(const char *cursol, const char *end);
+};
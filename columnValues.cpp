@@ -0,0 +1,139 @@
+#include "columnValues.hpp"
+
+#include <charconv>
+
+using namespace std;
+
+//! ColumnValuesクラスの新しいインスタンスを初期化します。
+//! @param [in] arena 値の配列の領域を切り出すArenaです。
+//! @param [in] pool 文字列の値に番号を振るプールです。nullptrの場合は番号で持ちません。
+ColumnValues::ColumnValues(Arena &arena, StringPool *pool) :
+	integers(arena),
+	strings(arena),
+	codes(arena),
+	pool(pool)
+{
+}
+
+//! 文字列型の列の末尾に値を追加します。番号で持たない場合は値を複写せずに参照します。
+//! @param [in] value 追加する値です。列を使い終わるまで有効な領域を参照している必要があります。
+void ColumnValues::AppendString(const string_view value)
+{
+	if (pool){
+		auto size = pool->Size();
+		codes.push_back(pool->Intern(value));
+		if (size == pool->Size() || ++internedCount <= maxInternedValues){
+			return;
+		}
+
+		// 異なる値が多い列は、それまでの値をプールの値を参照する配列に移し、以降は番号を振りません。
+		strings.reserve(codes.size());
+		for (auto code : codes) {
+			strings.push_back(pool->Cell(code).string());
+		}
+		codes.clear();
+		pool = nullptr;
+		return;
+	}
+	strings.push_back(value);
+}
+
+//! 文字列型の列の全ての値が整数であれば、整数型の列に変換します。判定と変換は一度に行い、番号で持つ列は異なる値ごとに一度だけ行います。
+//! 整数は符号を一つ前置できる十進数で、intの範囲に収まるものです。空文字列は整数ではありません。
+//! @return 変換した場合はtrueです。整数ではない値があった場合はfalseで、列は文字列型のまま変更しません。
+bool ColumnValues::ConvertToInteger()
+{
+	integers.reserve(strings.size() + codes.size());
+	if (pool){
+		vector<int> converted(pool->Size()); // 番号ごとの変換した値です。
+		vector<char> done(pool->Size());     // 番号ごとの、変換し終えたかどうかです。
+		for (auto code : codes) {
+			if (!done[code]){
+				if (!ParseInteger(pool->Cell(code).string(), converted[code])){
+					integers.clear();
+					return false;
+				}
+				done[code] = true;
+			}
+			integers.push_back(converted[code]);
+		}
+	}
+	else{
+		for (auto value : strings) {
+			int converted; // 変換した値です。
+			if (!ParseInteger(value, converted)){
+				integers.clear();
+				return false;
+			}
+			integers.push_back(converted);
+		}
+	}
+	type = DataType::INTEGER;
+	strings.clear();
+	codes.clear();
+	pool = nullptr;
+	return true;
+}
+
+//! 文字列を整数に変換します。例外を投げず、メモリも確保しません。
+//! @param [in] value 変換する文字列です。符号を一つ前置できる十進数である必要があります。
+//! @param [out] result 変換した値です。
+//! @return 値全体が整数で、intの範囲に収まる場合はtrueです。
+bool ColumnValues::ParseInteger(const string_view value, int &result)
+{
+	auto first = value.data();
+	auto last = value.data() + value.size();
+	// from_charsは+を受け付けないので、読み飛ばしてから変換します。
+	if (first != last && *first == '+'){
+		++first;
+		if (first != last && *first == '-'){
+			return false;
+		}
+	}
+	auto converted = from_chars(first, last, result);
+	return converted.ec == errc() && converted.ptr == last;
+}
+
+//! 文字列が、ConvertToIntegerで整数型に変換できる値かどうかを調べます。
+//! @param [in] value 調べる文字列です。
+//! @return 整数であればtrueです。
+bool ColumnValues::IsInteger(const string_view value)
+{
+	int converted; // 変換した値です。使いません。
+	return ParseInteger(value, converted);
+}
+
+//! 番号で持つ文字列型の列の番号を、StringPool::Sortで振り直した番号に置き換えます。
+//! @param [in] ranks 元の番号をインデックスとした、振り直した番号です。
+void ColumnValues::Recode(const vector<int> &ranks)
+{
+	for (auto &code : codes) {
+		code = ranks[code];
+	}
+}
+
+//! 文字列型の列の値を取得します。
+//! @param [in] row 値を取得する行です。
+//! @return 行の値です。入力ファイルをマッピングした領域かpoolを参照します。
+string_view ColumnValues::String(const int row) const
+{
+	if (pool){
+		return pool->Cell(Codes()[row]).string();
+	}
+	if (mappedEnds){
+		auto start = row ? mappedEnds[row - 1] : 0; // 値の開始位置です。
+		return string_view(mappedHeap + start, mappedEnds[row] - start);
+	}
+	return strings[row];
+}
+
+//! 列の値をデータとして取得します。
+//! @param [in] row 値を取得する行です。
+//! @return 行の値です。長い文字列は入力ファイルをマッピングした領域かpoolを参照します。
+Data ColumnValues::Cell(const int row) const
+{
+	if (type == DataType::INTEGER){
+		return Data(Integers()[row]);
+	}
+	return pool ? pool->Cell(Codes()[row]) : Data(String(row));
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "arena.hpp"
+#include "data.hpp"
+#include "stringPool.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//! 入力されたテーブルの一つの列の、全ての行の値です。
+//! 値は型ごとの連続した配列に持つので、列を読む処理は他の列のデータに触れません。配列の領域はクエリの実行ごとのArenaから切り出します。
+//! 文字列型の列は、異なる値が少ない間はStringPoolの番号の配列として持ち、多くなれば値を参照する配列に切り替えます。
+//! サイドカーファイルから読み込んだ列は配列を持たず、マッピングした領域を参照するので、値はIntegers、Codes、Stringで取得します。
+class ColumnValues
+{
+public:
+	static constexpr int maxInternedValues = 4096; //!< 列の値をStringPoolの番号で持つ、列が新たにプールに加えた値の数の上限です。
+
+	DataType type = DataType::STRING;   //!< 列の型です。列の全ての値が整数であれば整数型、それ以外は文字列型です。
+	ArenaVector<int> integers;          //!< 整数型の列の、各行の値です。
+	ArenaVector<std::string_view> strings; //!< 番号で持たない文字列型の列の、各行の値です。入力ファイルをマッピングした領域かpoolを参照します。
+	ArenaVector<int> codes;             //!< 番号で持つ文字列型の列の、各行の値のpoolでの番号です。
+	StringPool *pool;                   //!< 列の値を番号で持つ場合は、番号を振ったプールです。番号で持たない場合はnullptrです。
+	int internedCount = 0;              //!< 列がpoolに新たに加えた値の数です。
+	const int *mapped = nullptr;        //!< サイドカーファイルをマッピングした領域の、整数型の列の値か番号で持つ文字列型の列の番号の配列です。nullptrでなければintegersかcodesの代わりに使います。
+	const uint64_t *mappedEnds = nullptr; //!< サイドカーファイルをマッピングした領域の、番号で持たない文字列型の列の各値の終了位置です。nullptrでなければstringsの代わりに使います。
+	const char *mappedHeap = nullptr;   //!< mappedEndsの各値を並べた、サイドカーファイルをマッピングした領域です。
+
+	//! ColumnValuesクラスの新しいインスタンスを初期化します。
+	//! @param [in] arena 値の配列の領域を切り出すArenaです。
+	//! @param [in] pool 文字列の値に番号を振るプールです。nullptrの場合は番号で持ちません。
+	ColumnValues(Arena &arena, StringPool *pool);
+
+	//! 文字列型の列の末尾に値を追加します。番号で持たない場合は値を複写せずに参照します。
+	//! @param [in] value 追加する値です。列を使い終わるまで有効な領域を参照している必要があります。
+	void AppendString(const std::string_view value);
+
+	//! 文字列型の列の全ての値が整数であれば、整数型の列に変換します。判定と変換は一度に行い、番号で持つ列は異なる値ごとに一度だけ行います。
+	//! 整数は符号を一つ前置できる十進数で、intの範囲に収まるものです。空文字列は整数ではありません。
+	//! @return 変換した場合はtrueです。整数ではない値があった場合はfalseで、列は文字列型のまま変更しません。
+	bool ConvertToInteger();
+
+	//! 文字列を整数に変換します。例外を投げず、メモリも確保しません。
+	//! @param [in] value 変換する文字列です。符号を一つ前置できる十進数である必要があります。
+	//! @param [out] result 変換した値です。
+	//! @return 値全体が整数で、intの範囲に収まる場合はtrueです。
+	static bool ParseInteger(const std::string_view value, int &result);
+
+	//! 文字列が、ConvertToIntegerで整数型に変換できる値かどうかを調べます。
+	//! @param [in] value 調べる文字列です。
+	//! @return 整数であればtrueです。
+	static bool IsInteger(const std::string_view value);
+
+	//! 番号で持つ文字列型の列の番号を、StringPool::Sortで振り直した番号に置き換えます。
+	//! @param [in] ranks 元の番号をインデックスとした、振り直した番号です。
+	void Recode(const std::vector<int> &ranks);
+
+	//! 整数型の列の、各行の値の配列を取得します。
+	//! @return 各行の値の配列の先頭です。サイドカーファイルから読み込んだ列はマッピングした領域を参照します。
+	const int* Integers() const { return mapped ? mapped : integers.data(); }
+
+	//! 番号で持つ文字列型の列の、各行の番号の配列を取得します。
+	//! @return 各行の番号の配列の先頭です。サイドカーファイルから読み込んだ列はマッピングした領域を参照します。
+	const int* Codes() const { return mapped ? mapped : codes.data(); }
+
+	//! 文字列型の列の値を取得します。
+	//! @param [in] row 値を取得する行です。
+	//! @return 行の値です。入力ファイルをマッピングした領域かpoolを参照します。
+	std::string_view String(const int row) const;
+
+	//! 列の値をデータとして取得します。
+	//! @param [in] row 値を取得する行です。
+	//! @return 行の値です。長い文字列は入力ファイルをマッピングした領域かpoolを参照します。
+	Data Cell(const int row) const;
+};
@@ -0,0 +1,353 @@
+#include "columnarFile.hpp"
+#include "columnValues.hpp"
+#include "csvChunk.hpp"
+#include "resultValue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace std;
+
+namespace {
+	const char magic[4] = { 'T', 'C', 'O', 'L' }; //!< サイドカーファイルの先頭に置く、ファイルの種類を表す文字です。
+	atomic<bool> sidecarEnabled(false); //!< サイドカーファイルを使うかどうかです。
+
+	//! ファイル中の位置を、8バイトの倍数に切り上げます。
+	//! @param [in] offset 切り上げる位置です。
+	//! @return 切り上げた位置です。
+	uint64_t Align(const uint64_t offset)
+	{
+		return (offset + 7) & ~static_cast<uint64_t>(7);
+	}
+}
+
+//! CSVファイルに対応するサイドカーファイルを開きます。有効なファイルが無い場合は作成してから開きます。
+//! @param [in] path サイドカーファイルのパスです。
+//! @param [in] csv マッピングしたCSVファイルです。
+//! @param [in] dataStart csvのデータ行の先頭です。
+//! @param [in] columnCount CSVファイルのヘッダ行の列の数です。
+ColumnarFile::ColumnarFile(const string &path, const MappedFile &csv, const char *dataStart, const size_t columnCount)
+{
+	if (!Open(path, csv, columnCount) && Write(path, csv, dataStart, columnCount)){
+		Open(path, csv, columnCount);
+	}
+}
+
+//! サイドカーファイルが、CSVファイルに対応する有効なものであればマッピングします。
+//! @param [in] path サイドカーファイルのパスです。
+//! @param [in] csv マッピングしたCSVファイルです。
+//! @param [in] columnCount CSVファイルのヘッダ行の列の数です。
+//! @return 有効なファイルをマッピングした場合はtrueです。
+bool ColumnarFile::Open(const string &path, const MappedFile &csv, const size_t columnCount)
+{
+	try{
+		file = MappedFile(path);
+	}
+	catch (ResultValue){
+		return false;
+	}
+	auto contents = file.Contents(); // サイドカーファイルの内容です。
+	if (contents.size() < sizeof(Header) + columnCount * sizeof(ColumnEntry)){
+		return false;
+	}
+	auto candidate = reinterpret_cast<const Header*>(contents.data()); // 検査するファイルの先頭の情報です。
+	auto csvContents = csv.Contents(); // CSVファイルの内容です。
+	if (memcmp(candidate->magic, magic, sizeof(magic)) != 0 || candidate->version != version || candidate->columnCount != columnCount ||
+		candidate->csvSize != csvContents.size() || candidate->csvSeconds != csv.Modified().tv_sec || candidate->csvNanoseconds != csv.Modified().tv_nsec ||
+		candidate->csvHash != Hash(csvContents)){
+		return false;
+	}
+
+	// 壊れたファイルで領域の外を読まないように、各列の値が全てファイルに収まることを確かめます。
+	auto candidateEntries = reinterpret_cast<const ColumnEntry*>(contents.data() + sizeof(Header)); // 検査するファイルの列ごとの情報です。
+	auto rowCount = candidate->rowCount; // 行の数です。
+	if (contents.size() < rowCount){
+		return false;
+	}
+	for (size_t j = 0; j < columnCount; ++j){
+		auto &entry = candidateEntries[j];
+		auto integer = entry.type == static_cast<uint64_t>(DataType::INTEGER); // 整数型の列かどうかです。
+		auto coded = !integer && entry.dictionarySize != 0; // 番号で持つ文字列型の列かどうかです。
+		auto valuesEnd = entry.offset + rowCount * (integer || coded ? sizeof(int) : sizeof(uint64_t)); // 値の配列の終了位置です。
+		if (entry.offset % 8 != 0 || valuesEnd < entry.offset || contents.size() < valuesEnd){
+			return false;
+		}
+		if (integer){
+			continue;
+		}
+		if (entry.type != static_cast<uint64_t>(DataType::STRING) || contents.size() < entry.heapOffset || contents.size() - entry.heapOffset < entry.heapSize){
+			return false;
+		}
+		if (coded && (entry.dictionaryOffset % 8 != 0 || contents.size() / sizeof(uint64_t) < entry.dictionarySize ||
+			contents.size() < entry.dictionaryOffset || contents.size() - entry.dictionaryOffset < entry.dictionarySize * sizeof(uint64_t))){
+			return false;
+		}
+
+		// 各値の終了位置は、前の値の終了位置より前になく、値を並べた領域に収まる必要があります。番号で持つ列は辞書の値の終了位置です。
+		auto ends = reinterpret_cast<const uint64_t*>(contents.data() + (coded ? entry.dictionaryOffset : entry.offset)); // 各値の終了位置です。
+		auto endCount = coded ? entry.dictionarySize : rowCount; // 終了位置の数です。
+		uint64_t start = 0; // 値の開始位置です。
+		for (uint64_t k = 0; k < endCount; ++k){
+			if (ends[k] < start){
+				return false;
+			}
+			start = ends[k];
+		}
+		if (entry.heapSize < start){
+			return false;
+		}
+
+		// 番号で持つ列の番号は、辞書に収まる必要があります。
+		if (coded){
+			auto codes = reinterpret_cast<const int*>(contents.data() + entry.offset); // 各行の辞書での番号です。
+			for (uint64_t row = 0; row < rowCount; ++row){
+				if (codes[row] < 0 || entry.dictionarySize <= static_cast<uint64_t>(codes[row])){
+					return false;
+				}
+			}
+		}
+	}
+	header = candidate;
+	entries = candidateEntries;
+	return true;
+}
+
+//! CSVファイルのデータ行を読み、サイドカーファイルを作成します。
+//! 一度目の読み込みで列の型と大きさと異なる値を求めてから、二度目の読み込みでマッピングしたファイルに値を直接書くので、CSVファイルの大きさによらない量のメモリで作成します。
+//! 一時ファイルに書いてから名前を変えるので、同時に読むプロセスが書きかけのファイルを読むことはありません。
+//! @param [in] path サイドカーファイルのパスです。
+//! @param [in] csv マッピングしたCSVファイルです。
+//! @param [in] dataStart csvのデータ行の先頭です。
+//! @param [in] columnCount CSVファイルのヘッダ行の列の数です。
+//! @return 作成できた場合はtrueです。
+bool ColumnarFile::Write(const string &path, const MappedFile &csv, const char *dataStart, const size_t columnCount)
+{
+	auto csvContents = csv.Contents(); // CSVファイルの内容です。
+	auto dataEnd = csvContents.data() + csvContents.size(); // データ行の終了位置です。
+
+	// 列ごとに、全ての値が整数かどうかと、値の大きさの合計と、異なる値を求めます。
+	vector<char> integerColumns(columnCount, true); // 列ごとの、全ての値が整数かどうかです。
+	vector<char> codedColumns(columnCount, true); // 列ごとの、値を辞書の番号で持つかどうかです。
+	vector<uint64_t> heapSizes(columnCount); // 列ごとの、値の大きさの合計です。
+	vector<unordered_set<string_view>> distinctValues(columnCount); // 列ごとの異なる値です。番号で持たない列は空です。
+	uint64_t rowCount = CsvChunk::ForEachValue(dataStart, dataEnd, columnCount, [&](const size_t column, const string_view value) {
+		if (integerColumns[column] && !ColumnValues::IsInteger(value)){
+			integerColumns[column] = false;
+		}
+		heapSizes[column] += value.size();
+		if (codedColumns[column]){
+			auto &distinct = distinctValues[column];
+			distinct.insert(value);
+			if (ColumnValues::maxInternedValues < static_cast<int>(distinct.size())){
+				codedColumns[column] = false;
+				unordered_set<string_view>().swap(distinct);
+			}
+		}
+	});
+
+	// 番号で持つ列の、辞書順に並べた辞書を作ります。辞書の値だけを並べるので、値を並べた領域の大きさは辞書の値の大きさの合計です。
+	vector<vector<string_view>> dictionaries(columnCount); // 列ごとの、辞書順に並べた異なる値です。
+	vector<unordered_map<string_view, int>> codes(columnCount); // 列ごとの、値から辞書での番号を引く表です。
+	for (size_t j = 0; j < columnCount; ++j){
+		codedColumns[j] = codedColumns[j] && !integerColumns[j] && !distinctValues[j].empty();
+		if (!codedColumns[j]){
+			continue;
+		}
+		auto &dictionary = dictionaries[j];
+		dictionary.assign(distinctValues[j].begin(), distinctValues[j].end());
+		unordered_set<string_view>().swap(distinctValues[j]);
+		sort(dictionary.begin(), dictionary.end());
+		heapSizes[j] = 0;
+		for (size_t k = 0; k < dictionary.size(); ++k){
+			codes[j].emplace(dictionary[k], k);
+			heapSizes[j] += dictionary[k].size();
+		}
+	}
+
+	// 列ごとの値の位置を決めます。
+	vector<ColumnEntry> columnEntries(columnCount); // 列ごとの情報です。
+	uint64_t fileSize = Align(sizeof(Header) + columnCount * sizeof(ColumnEntry)); // 作成するファイルの大きさです。
+	for (size_t j = 0; j < columnCount; ++j){
+		auto &entry = columnEntries[j];
+		entry.offset = fileSize;
+		if (integerColumns[j]){
+			entry.type = static_cast<uint64_t>(DataType::INTEGER);
+			fileSize = Align(fileSize + rowCount * sizeof(int));
+		}
+		else if (codedColumns[j]){
+			entry.type = static_cast<uint64_t>(DataType::STRING);
+			entry.dictionaryOffset = Align(fileSize + rowCount * sizeof(int));
+			entry.dictionarySize = dictionaries[j].size();
+			entry.heapOffset = entry.dictionaryOffset + entry.dictionarySize * sizeof(uint64_t);
+			entry.heapSize = heapSizes[j];
+			fileSize = Align(entry.heapOffset + entry.heapSize);
+		}
+		else{
+			entry.type = static_cast<uint64_t>(DataType::STRING);
+			entry.heapOffset = fileSize + rowCount * sizeof(uint64_t);
+			entry.heapSize = heapSizes[j];
+			fileSize = Align(entry.heapOffset + entry.heapSize);
+		}
+	}
+
+	// 一時ファイルを作成し、大きさを決めてマッピングします。
+	auto temporaryPath = path + ".XXXXXX"; // 一時ファイルのパスです。末尾はmkstempが置き換えます。
+	auto descriptor = mkstemp(&temporaryPath[0]); // 一時ファイルのファイル記述子です。
+	if (descriptor < 0){
+		return false;
+	}
+	void *mapped = MAP_FAILED; // 一時ファイルをマッピングした領域です。
+	if (fchmod(descriptor, 0644) != 0 || ftruncate(descriptor, fileSize) != 0 ||
+		(mapped = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0)) == MAP_FAILED){
+		close(descriptor);
+		unlink(temporaryPath.c_str());
+		return false;
+	}
+	auto memory = static_cast<char*>(mapped); // 書き込む領域の先頭です。
+
+	// 番号で持つ列の辞書を書き込みます。
+	for (size_t j = 0; j < columnCount; ++j){
+		auto &entry = columnEntries[j];
+		uint64_t heapEnd = 0; // 辞書の値を並べた領域に書き込んだ大きさです。
+		for (size_t k = 0; k < dictionaries[j].size(); ++k){
+			auto value = dictionaries[j][k]; // 書き込む辞書の値です。
+			memcpy(memory + entry.heapOffset + heapEnd, value.data(), value.size());
+			heapEnd += value.size();
+			reinterpret_cast<uint64_t*>(memory + entry.dictionaryOffset)[k] = heapEnd;
+		}
+	}
+
+	// 各値を、列ごとの位置に書き込みます。
+	vector<uint64_t> rows(columnCount); // 列ごとの、書き込んだ値の数です。
+	vector<uint64_t> heapEnds(columnCount); // 列ごとの、値を並べた領域に書き込んだ大きさです。
+	CsvChunk::ForEachValue(dataStart, dataEnd, columnCount, [&](const size_t column, const string_view value) {
+		auto &entry = columnEntries[column];
+		if (integerColumns[column]){
+			ColumnValues::ParseInteger(value, reinterpret_cast<int*>(memory + entry.offset)[rows[column]++]);
+		}
+		else if (codedColumns[column]){
+			reinterpret_cast<int*>(memory + entry.offset)[rows[column]++] = codes[column].find(value)->second;
+		}
+		else{
+			memcpy(memory + entry.heapOffset + heapEnds[column], value.data(), value.size());
+			heapEnds[column] += value.size();
+			reinterpret_cast<uint64_t*>(memory + entry.offset)[rows[column]++] = heapEnds[column];
+		}
+	});
+	memcpy(memory + sizeof(Header), columnEntries.data(), columnCount * sizeof(ColumnEntry));
+
+	// 先頭の情報は値を書き終えてから書き込みます。
+	auto &written = *reinterpret_cast<Header*>(memory); // 書き込む先頭の情報です。
+	written.version = version;
+	written.csvSize = csvContents.size();
+	written.csvSeconds = csv.Modified().tv_sec;
+	written.csvNanoseconds = csv.Modified().tv_nsec;
+	written.csvHash = Hash(csvContents);
+	written.rowCount = rowCount;
+	written.columnCount = columnCount;
+	memcpy(written.magic, magic, sizeof(magic));
+
+	auto succeeded = munmap(mapped, fileSize) == 0; // 書き込めたかどうかです。
+	succeeded = close(descriptor) == 0 && succeeded;
+	succeeded = succeeded && rename(temporaryPath.c_str(), path.c_str()) == 0;
+	if (!succeeded){
+		unlink(temporaryPath.c_str());
+	}
+	return succeeded;
+}
+
+//! CSVファイルの内容のハッシュ値を求めます。
+//! 大きなファイルは先頭と末尾しか読まないので、中ほどだけを書き換えて大きさと更新時刻を戻したファイルは見分けられません。大きさと更新時刻の一致に加えた、弱い確認です。
+//! @param [in] contents CSVファイルの内容です。
+//! @return 先頭と末尾のhashedBytesずつから求めたハッシュ値です。
+uint64_t ColumnarFile::Hash(const string_view contents)
+{
+	// FNV-1aで、先頭と末尾の範囲を続けて求めます。範囲が重なる小さなファイルは全体から求めます。
+	uint64_t hash = 14695981039346656037ull; // 求めているハッシュ値です。
+	auto add = [&](const string_view bytes) {
+		for (auto c : bytes) {
+			hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+		}
+	};
+	if (contents.size() <= 2 * hashedBytes){
+		add(contents);
+	}
+	else{
+		add(contents.substr(0, hashedBytes));
+		add(contents.substr(contents.size() - hashedBytes));
+	}
+	return hash;
+}
+
+//! 有効なサイドカーファイルを開いているかどうかを取得します。作成できなかった場合はfalseで、CSVファイルから読み込む必要があります。
+//! @return 開いている場合はtrueです。
+bool ColumnarFile::IsOpen() const
+{
+	return header != nullptr;
+}
+
+//! サイドカーファイルの値をテーブルに読み込みます。値は複写せずにマッピングした領域を参照し、マッピングはテーブルに移します。
+//! 番号で持つ文字列型の列は、辞書の値を順に加えたプールをテーブルに追加し、その番号で持ちます。
+//! @param [in, out] table 値と行の数を設定するテーブルです。fileにサイドカーファイルのマッピングを設定し、poolsに辞書のプールを追加します。
+//! @param [in] referenced 列ごとの、値を読み込むかどうかです。読み込まない列のvaluesは空です。
+//! @param [in] arena 辞書のプールの領域を切り出すArenaです。
+void ColumnarFile::Load(InputTable &table, const vector<char> &referenced, Arena &arena)
+{
+	auto contents = file.Contents(); // サイドカーファイルの内容です。
+	table.values.clear();
+	for (size_t j = 0; j < header->columnCount; ++j){
+		table.values.emplace_back(arena, nullptr);
+		auto &column = table.values.back();
+		auto &entry = entries[j];
+		if (!referenced[j]){
+			continue;
+		}
+		if (entry.type == static_cast<uint64_t>(DataType::INTEGER)){
+			column.type = DataType::INTEGER;
+			column.mapped = reinterpret_cast<const int*>(contents.data() + entry.offset);
+		}
+		else if (entry.dictionarySize){
+			// 辞書は辞書順に並ぶので、プールの番号はそのまま辞書の番号です。
+			table.pools.emplace_back(arena);
+			auto &pool = table.pools.back(); // 列の辞書のプールです。
+			auto ends = reinterpret_cast<const uint64_t*>(contents.data() + entry.dictionaryOffset); // 辞書の各値の終了位置です。
+			auto heap = contents.data() + entry.heapOffset; // 辞書の値を並べた領域です。
+			uint64_t start = 0; // 値の開始位置です。
+			for (uint64_t k = 0; k < entry.dictionarySize; ++k){
+				pool.AppendSorted(string_view(heap + start, ends[k] - start));
+				start = ends[k];
+			}
+			column.pool = &pool;
+			column.mapped = reinterpret_cast<const int*>(contents.data() + entry.offset);
+		}
+		else{
+			column.mappedEnds = reinterpret_cast<const uint64_t*>(contents.data() + entry.offset);
+			column.mappedHeap = contents.data() + entry.heapOffset;
+		}
+	}
+	table.rowCount = static_cast<int>(header->rowCount);
+	table.file = move(file);
+	header = nullptr;
+	entries = nullptr;
+}
+
+//! サイドカーファイルを使うかどうかを設定します。プロセスで共有する設定です。
+//! @param [in] enabled 使う場合はtrueです。
+void ColumnarFile::Enable(const bool enabled)
+{
+	sidecarEnabled = enabled;
+}
+
+//! サイドカーファイルを使うかどうかを取得します。
+//! @return 使う場合はtrueです。
+bool ColumnarFile::IsEnabled()
+{
+	return sidecarEnabled;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "inputTable.hpp"
+#include "mappedFile.hpp"
+#include "arena.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//! CSVファイルの読み込んだ結果を、列ごとの型と値のままで保存したサイドカーファイルです。ファイル名はCSVファイルの名前に.tcolを付けたものです。
+//! 整数型の列はintの配列として持ちます。文字列型の列は、異なる値がColumnValues::maxInternedValues以下であれば、辞書順に並べた値の辞書と各行の辞書での番号の配列として持ち、それ以外は各値の終了位置の配列と値を並べた領域として持ちます。
+//! 読み込む際は字句の区切りも型の判定も番号を振ることも行わず、値の配列はマッピングした領域をそのまま参照します。
+//! サイドカーファイルには元のCSVファイルの大きさ、最終更新時刻、内容のハッシュ値を記録し、全てが一致する場合だけ使います。
+//! ハッシュ値は、ファイルを読むたびに全体を読まないように、先頭と末尾のhashedBytesずつから求めます。
+//! そのため中ほどだけを書き換えて大きさと更新時刻を戻したCSVファイルは見分けられず、ハッシュ値は大きさと更新時刻の一致に加えた弱い確認です。
+//! 開く際には、壊れたファイルで領域の外を読まないように、各列の値がファイルに収まり、文字列の終了位置が前の値より前になく、番号が辞書に収まることを確かめます。
+//! 使うかどうかはプロセスで共有する設定で、既定では使いません。
+class ColumnarFile
+{
+	//! ファイルの先頭に置く情報です。
+	struct Header {
+		char magic[4];          //!< ファイルの種類を表す"TCOL"です。書き終えてから設定します。
+		uint32_t version;       //!< ファイルの形式の版です。
+		uint64_t csvSize;       //!< 元のCSVファイルの大きさです。
+		int64_t csvSeconds;     //!< 元のCSVファイルの最終更新時刻の秒です。
+		int64_t csvNanoseconds; //!< 元のCSVファイルの最終更新時刻の秒未満のナノ秒です。
+		uint64_t csvHash;       //!< 元のCSVファイルの内容のハッシュ値です。
+		uint64_t rowCount;      //!< 行の数です。
+		uint64_t columnCount;   //!< 列の数です。
+	};
+
+	//! 列ごとに、Headerに続けて置く情報です。
+	struct ColumnEntry {
+		uint64_t type;             //!< 列の型です。DataTypeの値です。
+		uint64_t offset;           //!< 整数型の列の値の配列か、番号で持つ文字列型の列の番号の配列か、番号で持たない文字列型の列の値の終了位置の配列の、ファイルの先頭からの位置です。
+		uint64_t heapOffset;       //!< 文字列型の列の値か辞書の値を並べた領域の、ファイルの先頭からの位置です。
+		uint64_t heapSize;         //!< 文字列型の列の値か辞書の値を並べた領域の大きさです。
+		uint64_t dictionaryOffset; //!< 番号で持つ文字列型の列の、辞書の各値の終了位置の配列の、ファイルの先頭からの位置です。
+		uint64_t dictionarySize;   //!< 番号で持つ文字列型の列の、辞書の値の数です。番号で持たない列は0です。
+	};
+
+	static constexpr uint32_t version = 2;          //!< 書き込むファイルの形式の版です。
+	static constexpr size_t hashedBytes = 64 << 10; //!< CSVファイルのハッシュ値を求める、先頭と末尾のそれぞれのバイト数です。
+
+	MappedFile file;                     //!< マッピングしたサイドカーファイルです。有効なファイルが無い場合は何もマッピングしていません。
+	const Header *header = nullptr;      //!< fileの先頭の情報です。有効なファイルが無い場合はnullptrです。
+	const ColumnEntry *entries = nullptr; //!< fileの列ごとの情報です。
+
+	//! サイドカーファイルが、CSVファイルに対応する有効なものであればマッピングします。
+	//! @param [in] path サイドカーファイルのパスです。
+	//! @param [in] csv マッピングしたCSVファイルです。
+	//! @param [in] columnCount CSVファイルのヘッダ行の列の数です。
+	//! @return 有効なファイルをマッピングした場合はtrueです。
+	bool Open(const std::string &path, const MappedFile &csv, const size_t columnCount);
+
+	//! CSVファイルのデータ行を読み、サイドカーファイルを作成します。
+	//! 一度目の読み込みで列の型と大きさと異なる値を求めてから、二度目の読み込みでマッピングしたファイルに値を直接書くので、CSVファイルの大きさによらない量のメモリで作成します。
+	//! 一時ファイルに書いてから名前を変えるので、同時に読むプロセスが書きかけのファイルを読むことはありません。
+	//! @param [in] path サイドカーファイルのパスです。
+	//! @param [in] csv マッピングしたCSVファイルです。
+	//! @param [in] dataStart csvのデータ行の先頭です。
+	//! @param [in] columnCount CSVファイルのヘッダ行の列の数です。
+	//! @return 作成できた場合はtrueです。
+	static bool Write(const std::string &path, const MappedFile &csv, const char *dataStart, const size_t columnCount);
+
+	//! CSVファイルの内容のハッシュ値を求めます。
+	//! 大きなファイルは先頭と末尾しか読まないので、中ほどだけを書き換えて大きさと更新時刻を戻したファイルは見分けられません。大きさと更新時刻の一致に加えた、弱い確認です。
+	//! @param [in] contents CSVファイルの内容です。
+	//! @return 先頭と末尾のhashedBytesずつから求めたハッシュ値です。
+	static uint64_t Hash(const std::string_view contents);
+
+public:
+	static constexpr const char *extension = ".tcol"; //!< CSVファイルの名前に付けて、サイドカーファイルの名前とする拡張子です。
+
+	//! CSVファイルに対応するサイドカーファイルを開きます。有効なファイルが無い場合は作成してから開きます。
+	//! @param [in] path サイドカーファイルのパスです。
+	//! @param [in] csv マッピングしたCSVファイルです。
+	//! @param [in] dataStart csvのデータ行の先頭です。
+	//! @param [in] columnCount CSVファイルのヘッダ行の列の数です。
+	ColumnarFile(const std::string &path, const MappedFile &csv, const char *dataStart, const size_t columnCount);
+
+	//! 有効なサイドカーファイルを開いているかどうかを取得します。作成できなかった場合はfalseで、CSVファイルから読み込む必要があります。
+	//! @return 開いている場合はtrueです。
+	bool IsOpen() const;
+
+	//! サイドカーファイルの値をテーブルに読み込みます。値は複写せずにマッピングした領域を参照し、マッピングはテーブルに移します。
+	//! 番号で持つ文字列型の列は、辞書の値を順に加えたプールをテーブルに追加し、その番号で持ちます。
+	//! @param [in, out] table 値と行の数を設定するテーブルです。fileにサイドカーファイルのマッピングを設定し、poolsに辞書のプールを追加します。
+	//! @param [in] referenced 列ごとの、値を読み込むかどうかです。読み込まない列のvaluesは空です。
+	//! @param [in] arena 辞書のプールの領域を切り出すArenaです。
+	void Load(InputTable &table, const std::vector<char> &referenced, Arena &arena);
+
+	//! サイドカーファイルを使うかどうかを設定します。プロセスで共有する設定です。
+	//! @param [in] enabled 使う場合はtrueです。
+	static void Enable(const bool enabled);
+
+	//! サイドカーファイルを使うかどうかを取得します。
+	//! @return 使う場合はtrueです。
+	static bool IsEnabled();
+};
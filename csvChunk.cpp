@@ -0,0 +1,37 @@
+#include "csvChunk.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+//! 範囲のデータ行を読み込みます。ヘッダ行より多い列は読み飛ばし、少ない列は空文字列とします。
+//! @param [in] begin 範囲の先頭です。行の先頭である必要があります。
+//! @param [in] end 範囲の終了位置です。ファイルの末尾でなければ改行文字の直後である必要があります。
+//! @param [in] referenced ヘッダ行の列ごとの、値を読み込むかどうかです。読み込まない列のcolumnsは空となります。
+void CsvChunk::Parse(const char *begin, const char *end, const vector<char> &referenced)
+{
+	columns.assign(referenced.size(), vector<string_view>());
+	rowCount = ForEachValue(begin, end, referenced.size(), [&](const size_t column, const string_view value) {
+		if (referenced[column]){
+			columns[column].push_back(value);
+		}
+	});
+}
+
+//! ファイルのデータ行を、おおよそ同じ大きさの範囲に区切ります。区切りは改行文字の直後とします。
+//! @param [in] begin データ行の先頭です。
+//! @param [in] end データ行の終了位置です。
+//! @param [in] count 区切る範囲の数です。
+//! @return 範囲の区切りの位置です。先頭はbegin、末尾はendで、n番目の範囲はn番目からn+1番目までです。
+vector<const char*> CsvChunk::Split(const char *begin, const char *end, const int count)
+{
+	vector<const char*> boundaries = { begin };
+	for (int i = 1; i < count; ++i) {
+		// 均等に分けた位置から次の改行文字までを前の範囲に含めます。前の範囲の行が長い場合は、前の区切りより手前には戻りません。
+		auto position = max(begin + (end - begin) / count * i, boundaries.back());
+		auto newLine = static_cast<const char*>(memchr(position, '\n', end - position));
+		boundaries.push_back(newLine ? newLine + 1 : end);
+	}
+	boundaries.push_back(end);
+	return boundaries;
+}
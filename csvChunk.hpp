@@ -0,0 +1,98 @@
+#pragma once
+
+#include "csvScanner.hpp"
+
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+//! CSVファイルのデータ行を、改行文字の直後で区切った範囲ごとに読み込んだ結果です。
+//! 範囲ごとに別のスレッドで読み込めるように、StringPoolやArenaを使わず、値はファイルを参照する文字列として持ちます。
+class CsvChunk
+{
+public:
+	std::vector<std::vector<std::string_view>> columns; //!< 列ごとの、範囲の各行の値です。
+	int rowCount = 0; //!< 範囲の行の数です。
+
+	//! 範囲のデータ行を読み込みます。ヘッダ行より多い列は読み飛ばし、少ない列は空文字列とします。
+	//! @param [in] begin 範囲の先頭です。行の先頭である必要があります。
+	//! @param [in] end 範囲の終了位置です。ファイルの末尾でなければ改行文字の直後である必要があります。
+	//! @param [in] referenced ヘッダ行の列ごとの、値を読み込むかどうかです。読み込まない列のcolumnsは空となります。
+	void Parse(const char *begin, const char *end, const std::vector<char> &referenced);
+
+	//! ファイルのデータ行を、おおよそ同じ大きさの範囲に区切ります。区切りは改行文字の直後とします。
+	//! @param [in] begin データ行の先頭です。
+	//! @param [in] end データ行の終了位置です。
+	//! @param [in] count 区切る範囲の数です。
+	//! @return 範囲の区切りの位置です。先頭はbegin、末尾はendで、n番目の範囲はn番目からn+1番目までです。
+	static std::vector<const char*> Split(const char *begin, const char *end, const int count);
+
+	//! 範囲のデータ行を区切り、行の順、列の順に全ての値を渡します。ヘッダ行より多い列は読み飛ばし、少ない列は空文字列とします。
+	//! @param [in] begin 範囲の先頭です。行の先頭である必要があります。
+	//! @param [in] end 範囲の終了位置です。ファイルの末尾でなければ改行文字の直後である必要があります。
+	//! @param [in] columnCount ヘッダ行の列の数です。
+	//! @param [in] append 値を受け取る関数です。列のインデックスと値を引数に取ります。
+	//! @return 範囲の行の数です。
+	template <typename Append>
+	static int ForEachValue(const char *begin, const char *end, const size_t columnCount, const Append append);
+};
+
+//! 範囲のデータ行を区切り、行の順、列の順に全ての値を渡します。ヘッダ行より多い列は読み飛ばし、少ない列は空文字列とします。
+//! @param [in] begin 範囲の先頭です。行の先頭である必要があります。
+//! @param [in] end 範囲の終了位置です。ファイルの末尾でなければ改行文字の直後である必要があります。
+//! @param [in] columnCount ヘッダ行の列の数です。
+//! @param [in] append 値を受け取る関数です。列のインデックスと値を引数に取ります。
+//! @return 範囲の行の数です。
+template <typename Append>
+int CsvChunk::ForEachValue(const char *begin, const char *end, const size_t columnCount, const Append append)
+{
+	int rows = 0; // 読み込んだ行の数です。
+	size_t j = 0; // 読み込んでいる列のインデックスです。
+	auto lineStart = begin; // 読み込んでいる行の最初です。
+	auto columnStart = begin; // 読み込んでいる列の最初です。
+
+	// 列の値を一つ読み終えます。ヘッダ行より多い列は読み飛ばします。
+	auto endColumn = [&](const char *columnEnd) {
+		if (j < columnCount){
+			append(j++, std::string_view(columnStart, columnEnd - columnStart));
+		}
+		columnStart = columnEnd + 1;
+	};
+
+	// 行を一つ読み終えます。ヘッダ行より少ない列は空文字列とします。
+	auto endLine = [&]() {
+		for (; j < columnCount; ++j){
+			append(j, std::string_view());
+		}
+		j = 0;
+		lineStart = columnStart;
+		++rows;
+	};
+
+	// カンマと改行文字の位置をブロックごとにビットマスクとして求め、立っているビットの位置で列と行を区切ります。
+	for (auto blockStart = begin; blockStart < end; blockStart += CsvScanner::blockSize){
+		CsvScanner::Masks masks; // ブロック中のカンマと改行文字の位置です。
+		if (end - blockStart >= CsvScanner::blockSize){
+			masks = CsvScanner::Scan(blockStart);
+		}
+		else{
+			// ブロックに満たない範囲の末尾は、範囲の外を読まないように複写してから調べます。
+			char tail[CsvScanner::blockSize] = {};
+			memcpy(tail, blockStart, end - blockStart);
+			masks = CsvScanner::Scan(tail);
+		}
+		for (auto structurals = masks.commas | masks.newLines; structurals; structurals &= structurals - 1){
+			auto lowest = structurals & -structurals; // 次に区切る位置のビットです。
+			endColumn(blockStart + __builtin_ctzll(structurals));
+			if (masks.newLines & lowest){
+				endLine();
+			}
+		}
+	}
+	// 改行文字で終わらない最後の行も一行とします。
+	if (lineStart != end){
+		endColumn(end);
+		endLine();
+	}
+	return rows;
+}
@@ -0,0 +1,93 @@
+#include "csvScanner.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CSV_SCANNER_X86
+#endif
+
+namespace {
+	typedef CsvScanner::Masks (*ScanFunction)(const char *block); //!< Scanの実装の型です。
+
+	//! 実行するCPUで使える、最も速いScanの実装を選びます。
+	//! @return 選んだ実装です。
+	ScanFunction SelectScan()
+	{
+		return CsvScanner::SupportsAvx2() ? CsvScanner::ScanAvx2 : CsvScanner::ScanSse2;
+	}
+
+	const auto scan = SelectScan(); //!< 実行するCPUで使うScanの実装です。
+}
+
+//! ブロック中のカンマと改行文字の位置を求めます。
+//! @param [in] block 調べるブロックの先頭です。blockSizeバイトを読みます。
+//! @return ブロック中のカンマと改行文字の位置です。
+CsvScanner::Masks CsvScanner::Scan(const char *block)
+{
+	return scan(block);
+}
+
+//! 実行するCPUがAVX2に対応しているかどうかを調べます。
+//! @return AVX2に対応していればtrueです。
+bool CsvScanner::SupportsAvx2()
+{
+#if defined(CSV_SCANNER_X86)
+	// 静的変数の初期化から呼ばれても正しく判定できるように、CPUの情報を先に取得します。
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+//! Scanを一文字ずつ調べる実装で行います。
+CsvScanner::Masks CsvScanner::ScanScalar(const char *block)
+{
+	Masks masks = { 0, 0 };
+	for (int i = 0; i < blockSize; ++i) {
+		masks.commas |= static_cast<uint64_t>(block[i] == ',') << i;
+		masks.newLines |= static_cast<uint64_t>(block[i] == '\n') << i;
+	}
+	return masks;
+}
+
+//! ScanをSSE2で行います。SSE2が使えない環境ではScanScalarで行います。
+CsvScanner::Masks CsvScanner::ScanSse2(const char *block)
+{
+#if defined(__SSE2__)
+	Masks masks = { 0, 0 };
+	auto comma = _mm_set1_epi8(',');
+	auto newLine = _mm_set1_epi8('\n');
+	for (int i = 0; i < blockSize; i += 16) {
+		auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+		masks.commas |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, comma)))) << i;
+		masks.newLines |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newLine)))) << i;
+	}
+	return masks;
+#else
+	return ScanScalar(block);
+#endif
+}
+
+#if defined(CSV_SCANNER_X86)
+//! ScanをAVX2で行います。SupportsAvx2がfalseの環境で呼んではいけません。
+//! コンパイル時にAVX2を有効にしていなくても、この関数だけはAVX2の命令で生成します。
+__attribute__((target("avx2")))
+CsvScanner::Masks CsvScanner::ScanAvx2(const char *block)
+{
+	auto comma = _mm256_set1_epi8(',');
+	auto newLine = _mm256_set1_epi8('\n');
+	auto low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+	auto high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+	uint64_t lowCommas = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, comma)));
+	uint64_t highCommas = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, comma)));
+	uint64_t lowNewLines = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, newLine)));
+	uint64_t highNewLines = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, newLine)));
+	return { lowCommas | highCommas << 32, lowNewLines | highNewLines << 32 };
+}
+#else
+//! ScanをAVX2で行います。AVX2が使えない環境ではScanSse2で行います。
+CsvScanner::Masks CsvScanner::ScanAvx2(const char *block)
+{
+	return ScanSse2(block);
+}
+#endif
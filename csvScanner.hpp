@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+//! CSVのカンマと改行文字の位置を、64バイトごとのビットマスクとして求める機能を提供します。
+//! ビットマスクのn番目のビットは、ブロックのn番目のバイトに対応します。
+//! 実行するCPUがAVX2に対応していればAVX2で、そうでなければSSE2で、どちらも使えない環境では一文字ずつ調べる実装で求めます。実装は最初の呼び出しまでに一度だけ選びます。
+class CsvScanner
+{
+public:
+	static constexpr int blockSize = 64; //!< 一度に調べるバイト数です。
+
+	//! ブロック中のカンマと改行文字の位置です。
+	struct Masks
+	{
+		uint64_t commas;   //!< カンマの位置のビットが立ったマスクです。
+		uint64_t newLines; //!< 改行文字の位置のビットが立ったマスクです。
+	};
+
+	//! ブロック中のカンマと改行文字の位置を求めます。
+	//! @param [in] block 調べるブロックの先頭です。blockSizeバイトを読みます。
+	//! @return ブロック中のカンマと改行文字の位置です。
+	static Masks Scan(const char *block);
+
+	//! 実行するCPUがAVX2に対応しているかどうかを調べます。
+	//! @return AVX2に対応していればtrueです。
+	static bool SupportsAvx2();
+
+	//! Scanを一文字ずつ調べる実装で行います。
+	static Masks ScanScalar(const char *block);
+
+	//! ScanをSSE2で行います。SSE2が使えない環境ではScanScalarで行います。
+	static Masks ScanSse2(const char *block);
+
+	//! ScanをAVX2で行います。SupportsAvx2がfalseの環境で呼んではいけません。AVX2が使えない環境ではScanSse2で行います。
+	static Masks ScanAvx2(const char *block);
+};
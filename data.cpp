@@ -1,39 +1,81 @@
 #include "data.hpp"
 
-#include <algorithm>
-#include <string>
+#include <cstring>
+
+using namespace std;
 
 //! Dataクラスの新しいインスタンスを初期化
-Data::Data() : m_value({0})
+Data::Data() : m_header(static_cast<uint32_t>(DataType::STRING)), m_value()
 {
 
 }
 
 //! Dataクラスの新しいインスタンスを初期化
-Data::Data(const std::string value) : m_value({0})
+//! @param [in] value データの値
+Data::Data(const string_view value) : m_header(static_cast<uint32_t>(value.size() << 2) | static_cast<uint32_t>(DataType::STRING)), m_value()
+{
+    if (value.size() <= inlineSize){
+        memcpy(m_value.characters, value.data(), value.size());
+    }
+    else{
+        auto pointer = value.data();
+        memcpy(m_value.characters, pointer, prefixSize);
+        memcpy(m_value.characters + prefixSize, &pointer, sizeof(pointer));
+    }
+}
+
+//! Dataクラスの新しいインスタンスを初期化
+//! @param [in] value データの値
+//! @param [in] buffer 長い文字列の実体を格納する領域
+Data::Data(const string_view value, StringBuffer &buffer) :
+    Data(value.size() <= inlineSize ? value : buffer.Store(value))
 {
-    m_string = value;
+
 }
 
 //! Dataクラスの新しいインスタンスを初期化
 //! @param [in] value データの値
-Data::Data(const int value) :type(DataType::INTEGER)
+Data::Data(const int value) : m_header(static_cast<uint32_t>(DataType::INTEGER)), m_value()
 {
     m_value.integer = value;
 }
 
 //! Dataクラスの新しいインスタンスを初期化
 //! @param [in] value データの値
-Data::Data(const bool value) :type(DataType::BOOLEAN)
+Data::Data(const bool value) : m_header(static_cast<uint32_t>(DataType::BOOLEAN)), m_value()
 {
     m_value.boolean = value;
 }
 
+//! 長い文字列の実体へのポインタを取得します。
+//! @return 文字列の実体へのポインタです。
+const char* Data::Pointer() const
+{
+    const char *pointer;
+    memcpy(&pointer, m_value.characters + prefixSize, sizeof(pointer));
+    return pointer;
+}
+
+//! 文字列のバイト数を取得します。
+//! @return 文字列のバイト数です。
+size_t Data::Length() const
+{
+    return m_header >> 2;
+}
+
+//! データの型を取得します。
+//! @return データの型です。
+DataType Data::type() const
+{
+    return static_cast<DataType>(m_header & 3);
+}
+
 //! データが文字列型の場合の値を取得します。
 //! @return データが文字列型の場合の値です。
-const std::string& Data::string() const
+string_view Data::string() const
 {
-    return m_string;
+    auto length = Length();
+    return string_view(length <= inlineSize ? m_value.characters : Pointer(), length);
 }
 
 //! データが整数型の場合の値を取得します。
@@ -48,4 +90,39 @@ const int& Data::integer() const
 const bool& Data::boolean() const
 {
     return m_value.boolean;
-}
\ No newline at end of file
+}
+
+//! 文字列型のデータ同士が等しいかどうかを調べます。
+//! @param [in] other 比較するデータです。
+//! @return 等しければtrueです。
+bool Data::EqualString(const Data &other) const
+{
+    // バイト数と先頭4バイトが異なれば、実体を読まずに済みます。
+    if (m_header != other.m_header || memcmp(m_value.characters, other.m_value.characters, prefixSize) != 0){
+        return false;
+    }
+    auto length = Length();
+    if (length <= inlineSize){
+        return memcmp(m_value.characters + prefixSize, other.m_value.characters + prefixSize, inlineSize - prefixSize) == 0;
+    }
+    return memcmp(Pointer() + prefixSize, other.Pointer() + prefixSize, length - prefixSize) == 0;
+}
+
+//! 文字列型のデータ同士を辞書順で比較します。
+//! @param [in] other 比較するデータです。
+//! @return このデータが小さければ負の値、等しければ0、大きければ正の値です。
+int Data::CompareString(const Data &other) const
+{
+    // 先頭4バイトは短い文字列でも0で埋めてあるので、ビッグエンディアンの整数として比べれば辞書順になります。
+    uint32_t prefix, otherPrefix;
+    memcpy(&prefix, m_value.characters, prefixSize);
+    memcpy(&otherPrefix, other.m_value.characters, prefixSize);
+    if (prefix != otherPrefix){
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        prefix = __builtin_bswap32(prefix);
+        otherPrefix = __builtin_bswap32(otherPrefix);
+#endif
+        return prefix < otherPrefix ? -1 : 1;
+    }
+    return string().compare(other.string());
+}
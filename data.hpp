@@ -1,6 +1,9 @@
 #pragma once
 
-#include <string>
+#include "stringBuffer.hpp"
+
+#include <cstdint>
+#include <string_view>
 
 //! 入力や出力、経過の計算に利用するデータのデータ型の種類を表します。
 enum class DataType
@@ -10,26 +13,45 @@ enum class DataType
 	BOOLEAN   //!< 真偽値型です。
 };
 
-//! 一つの値を持つデータです。
+//! 一つの値を持つ16バイトのデータです。
+//! 12バイト以下の文字列はデータの中に直接格納します。それより長い文字列は先頭4バイトと、StringBufferなどデータの外に置かれた実体へのポインタを格納します。
+//! 文字列の比較は先頭4バイトが異なれば、実体を読まずに結果を返します。
 class Data {
-	std::string m_string; //!< データが文字列型の場合の値です。
+	static const size_t inlineSize = 12; //!< データの中に直接格納できる文字列の最大のバイト数です。
+	static const size_t prefixSize = 4;  //!< 長い文字列で、データの中に格納する先頭部分のバイト数です。
+
+	uint32_t m_header; //!< 下位2ビットがデータの型、残りのビットが文字列のバイト数です。
 
 	//! 実際のデータを格納する共用体です。
 	union
 	{
+		char characters[inlineSize];  //!< 短い文字列は全体を、長い文字列は先頭部分と実体へのポインタを格納します。使わない部分は0で埋めます。
 		int integer;                  //!< データが整数型の場合の値です。
 		bool boolean;                 //!< データが真偽値型の場合の値です。
 	} m_value;
 
-public:
-	DataType type = DataType::STRING; //!< データの型です。
+	//! 長い文字列の実体へのポインタを取得します。
+	//! @return 文字列の実体へのポインタです。
+	const char* Pointer() const;
 
+	//! 文字列のバイト数を取得します。
+	//! @return 文字列のバイト数です。
+	size_t Length() const;
+
+public:
 	//! Dataクラスの新しいインスタンスを初期化します。
 	Data();
 
 	//! Dataクラスの新しいインスタンスを初期化します。
+	//! 12バイトより長い文字列は実体をコピーしないので、呼び出し元がデータを使い終わるまで文字列を保持します。
+	//! @param [in] value データの値です。
+	explicit Data(const std::string_view value);
+
+	//! Dataクラスの新しいインスタンスを初期化します。
+	//! 12バイトより長い文字列は、実体をbufferにコピーします。
 	//! @param [in] value データの値です。
-	Data(const std::string value);
+	//! @param [in] buffer 長い文字列の実体を格納する領域です。
+	Data(const std::string_view value, StringBuffer &buffer);
 
 	//! Dataクラスの新しいインスタンスを初期化します。
 	//! @param [in] value データの値です。
@@ -39,9 +61,13 @@ public:
 	//! @param [in] value データの値です。
 	Data(const bool value);
 
+	//! データの型を取得します。
+	//! @return データの型です。
+	DataType type() const;
+
 	//! データが文字列型の場合の値を取得します。
 	//! @return データが文字列型の場合の値です。
-	const std::string& string() const;
+	std::string_view string() const;
 
 	//! データが整数型の場合の値を取得します。
 	//! @return データが整数型の場合の値です。
@@ -50,4 +76,16 @@ public:
 	//! データが真偽値型の場合の値を取得します。
 	//! @return データが真偽値型の場合の値です。
 	const bool& boolean() const;
+
+	//! 文字列型のデータ同士が等しいかどうかを調べます。
+	//! @param [in] other 比較するデータです。
+	//! @return 等しければtrueです。
+	bool EqualString(const Data &other) const;
+
+	//! 文字列型のデータ同士を辞書順で比較します。
+	//! @param [in] other 比較するデータです。
+	//! @return このデータが小さければ負の値、等しければ0、大きければ正の値です。
+	int CompareString(const Data &other) const;
 };
+
+static_assert(sizeof(Data) == 16, "Data must be 16 bytes.");
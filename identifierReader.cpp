@@ -1,21 +0,0 @@
-#include "identifierReader.hpp"
-
-#include <algorithm>
-
-using namespace std;
-
-//! 実際にトークンを読み込みます。
-//! @param [in] cursol 読み込み開始位置です。
-//! @param [in] end SQL全体の終了位置です。
-//! @return 切り出されたトークンです。読み込みが失敗した場合はnullptrを返します。
-const shared_ptr<const Token> IdentifierReader::ReadCore(string::const_iterator &cursol, const string::const_iterator &end) const
-{
-	auto start = cursol;
-	if (alpahUnder.find(*cursol++) != string::npos){
-		cursol = find_if(cursol, end, [&](const char c){return alpahNumUnder.find(c) == string::npos; });
-		return make_shared<Token>(TokenKind::IDENTIFIER, string(start, cursol));
-	}
-	else{
-		return nullptr;
-	}
-}
\ No newline at end of file
@@ -1,13 +1,30 @@
 #pragma once
 
 #include "column.hpp"
-#include "data.hpp"
+#include "columnValues.hpp"
+#include "mappedFile.hpp"
+#include "stringPool.hpp"
+#include <deque>
+#include <memory>
+#include <string_view>
 #include <vector>
 
 //! CSVとして入力されたファイルの内容を表します。
+//! 値は列ごとにまとめて持ちます。文字列の値は、テーブルが持つ入力ファイルのマッピングを参照します。
+//! TableCacheが保持するテーブルを使う場合は、値を持たずにsharedの値を参照するので、値はValuesで取得します。
 class InputTable
 {
 public:
 	std::vector<Column> columns; //!< 列の情報です。
-	std::vector<std::vector< Data>> data; //! データです。
-};
\ No newline at end of file
+	std::vector<ColumnValues> values; //!< 同じインデックスのcolumnsの列の、全ての行の値です。
+	int rowCount = 0; //!< 行の数です。
+	MappedFile file; //!< 入力ファイルをマッピングしたものです。valuesの文字列が参照するので、テーブルを使い終わるまで保持します。
+	std::string_view pendingRows; //!< 値を読み込まずに残したデータ行です。出力しながら少しずつ読み込むテーブルで、fileの領域を参照します。
+	std::deque<StringPool> pools; //!< サイドカーファイルから読み込んだ、番号で持つ文字列型の列ごとの辞書です。valuesの列が参照し、fileの領域を参照します。
+	std::shared_ptr<const InputTable> shared; //!< 値を参照する、TableCacheが保持するテーブルです。全ての列と全ての行を持ちます。値を自身で持つ場合はnullptrです。
+
+	//! 列の全ての行の値を取得します。
+	//! @param [in] column 値を取得する列のインデックスです。
+	//! @return 列の値です。sharedを参照する場合は、そのテーブルの値です。
+	const ColumnValues& Values(const size_t column) const { return shared ? shared->values[column] : values[column]; }
+};
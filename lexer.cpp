@@ -0,0 +1,224 @@
+#include "lexer.hpp"
+#include "resultValue.hpp"
+#include "charScanner.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+	const string space = " \t\r\n"; //!< 全ての空白文字です。
+	const string num = "0123456789"; //!< 全ての数字です。
+	const string alpahUnder = "_abcdefghijklmnopqrstuvwxzABCDEFGHIJKLMNOPQRSTUVWXYZ"; //!< 全てのアルファベットの大文字小文字とアンダーバーです。
+	const string alpahNumUnder = "_abcdefghijklmnopqrstuvwxzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"; //!< 全ての数字とアルファベットの大文字小文字とアンダーバーです。
+	const string keywordLetters = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"; //!< 大文字にするとキーワードの文字と比較できる全ての文字です。
+}
+
+//! Lexerクラスの新しいインスタンスを初期化します。
+Lexer::Lexer()
+{
+	// 文字種別の表を作成します。
+	for (auto c : space) {
+		charClasses[static_cast<unsigned char>(c)] |= SPACE;
+	}
+	for (auto c : num) {
+		charClasses[static_cast<unsigned char>(c)] |= DIGIT;
+	}
+	for (auto c : alpahUnder) {
+		charClasses[static_cast<unsigned char>(c)] |= IDENTIFIER_START;
+	}
+	for (auto c : alpahNumUnder) {
+		charClasses[static_cast<unsigned char>(c)] |= IDENTIFIER_PART;
+	}
+	for (auto c : keywordLetters) {
+		charClasses[static_cast<unsigned char>(c)] |= KEYWORD_LETTER;
+	}
+
+	// 一文字の記号の表を作成します。二文字の記号はTokenizeで先読みして判別します。
+	const vector<pair<char, TokenKind>> signs = {
+		{ '*', TokenKind::ASTERISK },
+		{ ',', TokenKind::COMMA },
+		{ ')', TokenKind::CLOSE_PAREN },
+		{ '.', TokenKind::DOT },
+		{ '=', TokenKind::EQUAL },
+		{ '>', TokenKind::GREATER_THAN },
+		{ '<', TokenKind::LESS_THAN },
+		{ '-', TokenKind::MINUS },
+		{ '(', TokenKind::OPEN_PAREN },
+		{ '+', TokenKind::PLUS },
+		{ '/', TokenKind::SLASH },
+	};
+	for (auto &sign : signs) {
+		signKinds[static_cast<unsigned char>(sign.first)] = sign.second;
+	}
+
+	// キーワードの完全ハッシュ表を作成します。
+	const vector<Keyword> allKeywords = {
+		{ "AND", TokenKind::AND },
+		{ "ASC", TokenKind::ASC },
+		{ "BY", TokenKind::BY },
+		{ "DESC", TokenKind::DESC },
+		{ "FROM", TokenKind::FROM },
+		{ "ORDER", TokenKind::ORDER },
+		{ "OR", TokenKind::OR },
+		{ "SELECT", TokenKind::SELECT },
+		{ "WHERE", TokenKind::WHERE },
+	};
+	for (auto &keyword : allKeywords) {
+		keywords[KeywordHash(keyword.word.front(), keyword.word.back(), keyword.word.size())] = keyword;
+	}
+}
+
+//! プロセスで共有される字句解析器を取得します。
+//! @return 初回の呼び出しで構築された字句解析器です。
+const Lexer& Lexer::Instance()
+{
+	static const Lexer lexer;
+	return lexer;
+}
+
+//! 文字の文字種別を調べます。
+//! @param [in] c 調べる文字です。
+//! @param [in] charClass 調べる文字種別です。
+//! @return 文字が指定された文字種別かどうかです。
+bool Lexer::Is(const char c, const CharClass charClass) const
+{
+	return charClasses[static_cast<unsigned char>(c)] & charClass;
+}
+
+//! 大文字にしたキーワード候補の完全ハッシュ値を計算します。
+//! @param [in] first 候補の先頭文字を大文字にしたものです。
+//! @param [in] last 候補の末尾文字を大文字にしたものです。
+//! @param [in] length 候補の文字数です。
+//! @return キーワードの完全ハッシュ表のインデックスです。
+int Lexer::KeywordHash(const char first, const char last, const size_t length)
+{
+	// 係数は全てのキーワードが衝突しないように選んであります。キーワードを追加する場合は選びなおしてください。
+	return (first * 3 + last * 5 + static_cast<int>(length)) % keywordTableSize;
+}
+
+//! 現在位置からキーワードを読み込みます。
+//! @param [in] cursol 読み込み開始位置です。キーワードが読み込めた場合はその次の位置に進めます。
+//! @param [in] end SQL全体の終了位置です。
+//! @return 読み込んだキーワードです。キーワードでない場合はnullptrを返します。
+const Lexer::Keyword* Lexer::ReadKeyword(const char *&cursol, const char *end) const
+{
+	char upper[maxKeywordLength]; // キーワード候補を大文字にしたものです。
+	size_t letterCount = 0; // キーワード候補として読んだ文字数です。
+	while (cursol + letterCount != end && letterCount < maxKeywordLength && Is(cursol[letterCount], KEYWORD_LETTER)) {
+		upper[letterCount] = static_cast<char>(toupper(static_cast<unsigned char>(cursol[letterCount])));
+		++letterCount;
+	}
+
+	// 長い候補から順に調べます。前方一致となるORDERとORでは、ORDERが優先されます。
+	for (size_t length = letterCount; 0 < length; --length) {
+		// キーワードに識別子が区切りなしに続いていないかを確認します。
+		auto next = cursol + length;
+		if (next == end || Is(*next, IDENTIFIER_PART)) {
+			continue;
+		}
+		auto &keyword = keywords[KeywordHash(upper[0], upper[length - 1], length)];
+		if (keyword.word.size() == length && equal(keyword.word.begin(), keyword.word.end(), upper)) {
+			cursol = next;
+			return &keyword;
+		}
+	}
+	return nullptr;
+}
+
+//! SQLをトークンに分解します。
+//! @param [in] sql トークンに分解する元となるSQLです。切り出されたトークンはこの領域を参照します。
+//! @param [out] tokens 切り出されたトークンを末尾に追加する先です。
+void Lexer::Tokenize(const string_view sql, vector<Token> &tokens) const
+{
+	auto cursol = sql.data(); // SQLをトークンに分割して読み込む時に現在読んでいる文字の場所を表します。
+	auto end = sql.data() + sql.size(); // sqlの終端を指します。
+
+	// メトリクス測定ツールのccccはシングルクォートの文字リテラル中のエスケープを認識しないため、文字リテラルを使わないことで回避しています。
+	const char quote = "\'"[0];
+
+	while (cursol != end) {
+		auto start = cursol; // 読み込み中のトークンの開始位置です。
+
+		// 空白を読み飛ばします。
+		if (Is(*cursol, SPACE)) {
+			cursol = CharScanner::SkipSpaces(cursol + 1, end);
+			continue;
+		}
+
+		// 数値リテラルを読み込みます。
+		if (Is(*cursol, DIGIT)) {
+			cursol = CharScanner::SkipDigits(cursol + 1, end);
+
+			// 数字の後にすぐに識別子が続くのは紛らわしいので数値リテラルとは扱いません。
+			if (cursol != end && Is(*cursol, IDENTIFIER_START)) {
+				throw ResultValue::ERR_TOKEN_CANT_READ;
+			}
+			tokens.push_back(Token(TokenKind::INT_LITERAL, string_view(start, cursol - start)));
+			continue;
+		}
+
+		// 文字列リテラルを読み込みます。
+		if (*cursol == quote) {
+			cursol = CharScanner::FindQuote(cursol + 1, end);
+			if (cursol == end) {
+				throw ResultValue::ERR_TOKEN_CANT_READ;
+			}
+			++cursol;
+			tokens.push_back(Token(TokenKind::STRING_LITERAL, string_view(start, cursol - start)));
+			continue;
+		}
+
+		// キーワードを読み込みます。
+		auto keyword = ReadKeyword(cursol, end);
+		if (keyword) {
+			tokens.push_back(Token(keyword->kind, keyword->word));
+			continue;
+		}
+
+		// 記号を読み込みます。二文字の記号は一文字の記号より先に判別します。
+		auto next = cursol + 1;
+		if (next != end && *next == '=' && (*cursol == '>' || *cursol == '<')) {
+			cursol += 2;
+			tokens.push_back(Token(*start == '>' ? TokenKind::GREATER_THAN_OR_EQUAL : TokenKind::LESS_THAN_OR_EQUAL, string_view(start, cursol - start)));
+			continue;
+		}
+		if (next != end && *cursol == '<' && *next == '>') {
+			cursol += 2;
+			tokens.push_back(Token(TokenKind::NOT_EQUAL, string_view(start, cursol - start)));
+			continue;
+		}
+		auto signKind = signKinds[static_cast<unsigned char>(*cursol)];
+		if (signKind != TokenKind::NOT_TOKEN) {
+			++cursol;
+			tokens.push_back(Token(signKind, string_view(start, cursol - start)));
+			continue;
+		}
+
+		// 位置で指定するパラメータのプレースホルダーを読み込みます。
+		if (*cursol == '?') {
+			++cursol;
+			tokens.push_back(Token(TokenKind::PARAMETER, string_view(start, cursol - start)));
+			continue;
+		}
+
+		// 名前で指定するパラメータのプレースホルダーを読み込みます。名前は識別子と同じ規則で読み込みます。
+		if (*cursol == ':') {
+			if (next == end || !Is(*next, IDENTIFIER_START)) {
+				throw ResultValue::ERR_TOKEN_CANT_READ;
+			}
+			cursol = CharScanner::SkipIdentifierPart(next + 1, end);
+			tokens.push_back(Token(TokenKind::PARAMETER, string_view(start, cursol - start)));
+			continue;
+		}
+
+		// 識別子を読み込みます。
+		if (Is(*cursol, IDENTIFIER_START)) {
+			cursol = CharScanner::SkipIdentifierPart(cursol + 1, end);
+			tokens.push_back(Token(TokenKind::IDENTIFIER, string_view(start, cursol - start)));
+			continue;
+		}
+
+		throw ResultValue::ERR_TOKEN_CANT_READ;
+	}
+}
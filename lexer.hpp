@@ -0,0 +1,66 @@
+#pragma once
+
+#include "token.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+//! SQLを一文字ずつ一度だけ読み、トークンに分解する字句解析器です。
+//! 文字種別の表とキーワードの完全ハッシュ表はプロセスで一度だけ構築されます。
+class Lexer
+{
+	//! 文字種別を表すビットです。
+	enum CharClass : unsigned char {
+		SPACE = 1,            //!< 空白文字です。
+		DIGIT = 2,            //!< 数字です。
+		IDENTIFIER_START = 4, //!< 識別子の先頭になれる文字です。
+		IDENTIFIER_PART = 8,  //!< 識別子の二文字目以降になれる文字です。
+		KEYWORD_LETTER = 16   //!< キーワードを構成するアルファベットです。
+	};
+
+	//! キーワードの完全ハッシュ表の一要素です。
+	struct Keyword {
+		std::string word;                       //!< 大文字で表したキーワードの文字列です。
+		TokenKind kind = TokenKind::NOT_TOKEN;  //!< キーワードのトークンの種類です。
+	};
+
+	static const int keywordTableSize = 9;     //!< キーワードの完全ハッシュ表の大きさです。
+	static const size_t maxKeywordLength = 6;  //!< 最も長いキーワードの文字数です。
+
+	unsigned char charClasses[256] = {};       //!< 文字ごとの文字種別のビットの組み合わせです。
+	TokenKind signKinds[256] = {};             //!< 一文字の記号のトークンの種類です。記号でない文字はNOT_TOKENです。
+	Keyword keywords[keywordTableSize];        //!< キーワードの完全ハッシュ表です。
+
+	//! Lexerクラスの新しいインスタンスを初期化します。
+	Lexer();
+
+	//! 文字の文字種別を調べます。
+	//! @param [in] c 調べる文字です。
+	//! @param [in] charClass 調べる文字種別です。
+	//! @return 文字が指定された文字種別かどうかです。
+	bool Is(const char c, const CharClass charClass) const;
+
+	//! 大文字にしたキーワード候補の完全ハッシュ値を計算します。
+	//! @param [in] first 候補の先頭文字を大文字にしたものです。
+	//! @param [in] last 候補の末尾文字を大文字にしたものです。
+	//! @param [in] length 候補の文字数です。
+	//! @return キーワードの完全ハッシュ表のインデックスです。
+	static int KeywordHash(const char first, const char last, const size_t length);
+
+	//! 現在位置からキーワードを読み込みます。
+	//! @param [in] cursol 読み込み開始位置です。キーワードが読み込めた場合はその次の位置に進めます。
+	//! @param [in] end SQL全体の終了位置です。
+	//! @return 読み込んだキーワードです。キーワードでない場合はnullptrを返します。
+	const Keyword* ReadKeyword(const char *&cursol, const char *end) const;
+
+public:
+	//! プロセスで共有される字句解析器を取得します。
+	//! @return 初回の呼び出しで構築された字句解析器です。
+	static const Lexer& Instance();
+
+	//! SQLをトークンに分解します。
+	//! @param [in] sql トークンに分解する元となるSQLです。切り出されたトークンはこの領域を参照します。
+	//! @param [out] tokens 切り出されたトークンを末尾に追加する先です。
+	void Tokenize(const std::string_view sql, std::vector<Token> &tokens) const;
+};
@@ -0,0 +1,107 @@
+#include "mappedFile.hpp"
+#include "resultValue.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+//! ファイルをマッピングしてMappedFileクラスの新しいインスタンスを初期化します。
+//! @param [in] path マッピングするファイルのパスです。
+//! @exception ResultValue ファイルを開けないかマッピングできない場合はERR_FILE_OPEN、閉じられない場合はERR_FILE_CLOSEです。
+MappedFile::MappedFile(const string &path)
+{
+	auto file = open(path.c_str(), O_RDONLY); // マッピングするファイルのファイル記述子です。
+	if (file < 0){
+		throw ResultValue::ERR_FILE_OPEN;
+	}
+	struct stat status; // ファイルの情報です。
+	if (fstat(file, &status) != 0 || !S_ISREG(status.st_mode)){
+		close(file);
+		throw ResultValue::ERR_FILE_OPEN;
+	}
+	modified = status.st_mtim;
+
+	// 空のファイルはマッピングできないので、何もマッピングしない状態とします。
+	if (0 < status.st_size){
+		auto mapped = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (mapped == MAP_FAILED){
+			close(file);
+			throw ResultValue::ERR_FILE_OPEN;
+		}
+		data = static_cast<const char*>(mapped);
+		size = status.st_size;
+		madvise(mapped, size, MADV_SEQUENTIAL);
+		madvise(mapped, size, MADV_WILLNEED);
+	}
+
+	// マッピングはファイル記述子を閉じても有効です。
+	if (close(file) != 0){
+		throw ResultValue::ERR_FILE_CLOSE;
+	}
+}
+
+//! マッピングを解除します。
+MappedFile::~MappedFile()
+{
+	if (data){
+		munmap(const_cast<char*>(data), size);
+	}
+}
+
+//! 他のインスタンスのマッピングを引き継ぎます。
+//! @param [in] other マッピングを引き継ぐインスタンスです。何もマッピングしていない状態になります。
+MappedFile::MappedFile(MappedFile &&other) noexcept :
+	data(exchange(other.data, nullptr)),
+	size(exchange(other.size, 0)),
+	modified(exchange(other.modified, timespec()))
+{
+}
+
+//! 現在のマッピングを解除し、他のインスタンスのマッピングを引き継ぎます。
+//! @param [in] other マッピングを引き継ぐインスタンスです。何もマッピングしていない状態になります。
+//! @return このインスタンスです。
+MappedFile& MappedFile::operator=(MappedFile &&other) noexcept
+{
+	if (this != &other){
+		if (data){
+			munmap(const_cast<char*>(data), size);
+		}
+		data = exchange(other.data, nullptr);
+		size = exchange(other.size, 0);
+		modified = exchange(other.modified, timespec());
+	}
+	return *this;
+}
+
+//! ファイルの内容を取得します。
+//! @return ファイルの内容です。マッピングした領域を参照します。
+string_view MappedFile::Contents() const
+{
+	return string_view(data, size);
+}
+
+//! マッピングした時点の、ファイルの最終更新時刻を取得します。マッピングに使ったファイル記述子から取得するので、後でパスのファイルが置き換えられても、マッピングしたファイルの時刻です。
+//! @return ファイルの最終更新時刻です。何もマッピングしていない場合は0です。
+const timespec& MappedFile::Modified() const
+{
+	return modified;
+}
+
+//! 読み終えた範囲のページを、プロセスのメモリから外します。ページはページキャッシュに残り、再び読むとファイルから読み直します。
+//! 範囲の先頭を含むページも外すので、範囲より前も読み終えている必要があります。範囲の終了位置を含むページは外しません。
+//! @param [in] begin 範囲の先頭です。マッピングした領域を指します。
+//! @param [in] end 範囲の終了位置です。マッピングした領域を指します。
+void MappedFile::Discard(const char *begin, const char *end) const
+{
+	auto pageMask = ~(static_cast<uintptr_t>(sysconf(_SC_PAGESIZE)) - 1); // アドレスをページの先頭に切り下げるマスクです。
+	auto first = reinterpret_cast<uintptr_t>(begin) & pageMask; // 外す最初のページの先頭です。
+	auto last = reinterpret_cast<uintptr_t>(end) & pageMask; // 外す範囲の終了位置です。
+	if (first < last){
+		madvise(reinterpret_cast<void*>(first), last - first, MADV_DONTNEED);
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <ctime>
+#include <string>
+#include <string_view>
+
+//! 読み込み専用でメモリにマッピングしたファイルです。
+//! 先頭から順に読むことと、すぐに読むことをカーネルに伝えるので、ファイル全体を先読みしながら読めます。
+//! マッピングした領域はMappedFileが破棄されるまで、ムーブされても同じ位置で使えます。
+class MappedFile
+{
+	const char *data = nullptr; //!< マッピングした領域の先頭です。空のファイルではnullptrです。
+	size_t size = 0;            //!< ファイルの大きさです。
+	timespec modified = {};     //!< マッピングした時点の、ファイルの最終更新時刻です。
+
+public:
+	//! 何もマッピングしていないMappedFileクラスの新しいインスタンスを初期化します。
+	MappedFile() = default;
+
+	//! ファイルをマッピングしてMappedFileクラスの新しいインスタンスを初期化します。
+	//! @param [in] path マッピングするファイルのパスです。
+	//! @exception ResultValue ファイルを開けないかマッピングできない場合はERR_FILE_OPEN、閉じられない場合はERR_FILE_CLOSEです。
+	explicit MappedFile(const std::string &path);
+
+	//! マッピングを解除します。
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	//! 他のインスタンスのマッピングを引き継ぎます。
+	//! @param [in] other マッピングを引き継ぐインスタンスです。何もマッピングしていない状態になります。
+	MappedFile(MappedFile &&other) noexcept;
+
+	//! 現在のマッピングを解除し、他のインスタンスのマッピングを引き継ぎます。
+	//! @param [in] other マッピングを引き継ぐインスタンスです。何もマッピングしていない状態になります。
+	//! @return このインスタンスです。
+	MappedFile& operator=(MappedFile &&other) noexcept;
+
+	//! ファイルの内容を取得します。
+	//! @return ファイルの内容です。マッピングした領域を参照します。
+	std::string_view Contents() const;
+
+	//! マッピングした時点の、ファイルの最終更新時刻を取得します。マッピングに使ったファイル記述子から取得するので、後でパスのファイルが置き換えられても、マッピングしたファイルの時刻です。
+	//! @return ファイルの最終更新時刻です。何もマッピングしていない場合は0です。
+	const timespec& Modified() const;
+
+	//! 読み終えた範囲のページを、プロセスのメモリから外します。ページはページキャッシュに残り、再び読むとファイルから読み直します。
+	//! 範囲の先頭を含むページも外すので、範囲より前も読み終えている必要があります。範囲の終了位置を含むページは外しません。
+	//! @param [in] begin 範囲の先頭です。マッピングした領域を指します。
+	//! @param [in] end 範囲の終了位置です。マッピングした領域を指します。
+	void Discard(const char *begin, const char *end) const;
+};
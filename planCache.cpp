@@ -0,0 +1,86 @@
+#include "planCache.hpp"
+
+using namespace std;
+
+//! PlanCacheクラスの新しいインスタンスを初期化します。
+//! @param [in] capacity 保持する構文情報の数の上限です。
+PlanCache::PlanCache(const size_t capacity) : capacity(capacity)
+{
+}
+
+//! プロセスで共有されるキャッシュを取得します。
+//! @return 初回の呼び出しで構築されたキャッシュです。
+PlanCache& PlanCache::Instance()
+{
+	static PlanCache instance(defaultCapacity);
+	return instance;
+}
+
+//! キーに対応する構文情報を検索します。見つかった構文情報は最も最近使われたものとなります。
+//! @param [in] key 正規化したSQLです。
+//! @return 見つかった構文情報です。見つからなかった場合はnullptrを返します。
+shared_ptr<const SqlQueryInfo> PlanCache::Find(const string &key)
+{
+	lock_guard<mutex> lock(entriesMutex);
+	auto found = index.find(key);
+	if (found == index.end()){
+		++misses;
+		return nullptr;
+	}
+	++hits;
+	entries.splice(entries.begin(), entries, found->second);
+	return found->second->second;
+}
+
+//! キーに対応する構文情報を追加します。上限を超えた場合は最も長く使われていない構文情報を捨てます。
+//! @param [in] key 正規化したSQLです。
+//! @param [in] queryInfo 追加する構文情報です。
+void PlanCache::Add(const string &key, const shared_ptr<const SqlQueryInfo> queryInfo)
+{
+	lock_guard<mutex> lock(entriesMutex);
+
+	// 他のスレッドが先に追加していた場合は、そちらを使い続けます。
+	if (index.find(key) != index.end() || capacity == 0){
+		return;
+	}
+	entries.emplace_front(key, queryInfo);
+	index[key] = entries.begin();
+	if (capacity < entries.size()){
+		index.erase(entries.back().first);
+		entries.pop_back();
+	}
+}
+
+//! 保持している構文情報を全て捨て、回数を0に戻します。
+void PlanCache::Clear()
+{
+	lock_guard<mutex> lock(entriesMutex);
+	index.clear();
+	entries.clear();
+	hits = 0;
+	misses = 0;
+}
+
+//! Findで構文情報が見つかった回数を取得します。
+//! @return 構文情報が見つかった回数です。
+size_t PlanCache::Hits() const
+{
+	lock_guard<mutex> lock(entriesMutex);
+	return hits;
+}
+
+//! Findで構文情報が見つからなかった回数を取得します。
+//! @return 構文情報が見つからなかった回数です。
+size_t PlanCache::Misses() const
+{
+	lock_guard<mutex> lock(entriesMutex);
+	return misses;
+}
+
+//! 保持している構文情報の数を取得します。
+//! @return 保持している構文情報の数です。
+size_t PlanCache::Size() const
+{
+	lock_guard<mutex> lock(entriesMutex);
+	return entries.size();
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "sqlQueryInfo.hpp"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+//! 解析済みのSQLの構文情報を、正規化したSQLをキーとして保持するキャッシュです。
+//! 上限を超えた場合は最も長く使われていない構文情報から捨てます。全てのメソッドは複数のスレッドから同時に呼び出すことができます。
+class PlanCache
+{
+	//! 最近使われた順に並べた、キーと構文情報の組です。
+	typedef std::list<std::pair<std::string, std::shared_ptr<const SqlQueryInfo>>> Entries;
+
+	const size_t capacity;                                          //!< 保持する構文情報の数の上限です。
+	mutable std::mutex entriesMutex;                                //!< 以下のメンバへのアクセスを排他します。
+	Entries entries;                                                //!< 保持している構文情報です。先頭が最も最近使われたものです。
+	std::unordered_map<std::string, Entries::iterator> index;      //!< キーからentriesの要素を引く表です。
+	size_t hits = 0;                                                //!< Findで構文情報が見つかった回数です。
+	size_t misses = 0;                                              //!< Findで構文情報が見つからなかった回数です。
+
+public:
+	static const size_t defaultCapacity = 256;                      //!< プロセスで共有されるキャッシュが保持する構文情報の数の上限です。
+
+	//! PlanCacheクラスの新しいインスタンスを初期化します。
+	//! @param [in] capacity 保持する構文情報の数の上限です。
+	PlanCache(const size_t capacity);
+
+	//! プロセスで共有されるキャッシュを取得します。
+	//! @return 初回の呼び出しで構築されたキャッシュです。
+	static PlanCache& Instance();
+
+	//! キーに対応する構文情報を検索します。見つかった構文情報は最も最近使われたものとなります。
+	//! @param [in] key 正規化したSQLです。
+	//! @return 見つかった構文情報です。見つからなかった場合はnullptrを返します。
+	std::shared_ptr<const SqlQueryInfo> Find(const std::string &key);
+
+	//! キーに対応する構文情報を追加します。上限を超えた場合は最も長く使われていない構文情報を捨てます。
+	//! @param [in] key 正規化したSQLです。
+	//! @param [in] queryInfo 追加する構文情報です。
+	void Add(const std::string &key, const std::shared_ptr<const SqlQueryInfo> queryInfo);
+
+	//! 保持している構文情報を全て捨て、回数を0に戻します。
+	void Clear();
+
+	//! Findで構文情報が見つかった回数を取得します。
+	//! @return 構文情報が見つかった回数です。
+	size_t Hits() const;
+
+	//! Findで構文情報が見つからなかった回数を取得します。
+	//! @return 構文情報が見つからなかった回数です。
+	size_t Misses() const;
+
+	//! 保持している構文情報の数を取得します。
+	//! @return 保持している構文情報の数です。
+	size_t Size() const;
+};
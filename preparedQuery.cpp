@@ -0,0 +1,101 @@
+#include "preparedQuery.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+//! PreparedQueryクラスの新しいインスタンスを初期化します。
+//! @param [in] sql 実行するSQLです。
+//! @exception ResultValue SQLの解析に失敗した場合は、ExecuteSQLと同じ値で失敗の種類を表します。
+PreparedQuery::PreparedQuery(const string sql) :
+	query(sql)
+{
+	parameters.resize(query.GetParameterNames().size());
+	strings.resize(query.GetParameterNames().size());
+	bound.resize(query.GetParameterNames().size());
+}
+
+//! パラメータに値を設定します。
+//! @param [in] index 値を設定するパラメータの、1から始まる番号です。
+//! @param [in] value 設定する値です。
+//! @param [in] text 文字列の値を設定する場合は、その文字列です。
+//! @exception ResultValue 番号に対応するパラメータが存在しない場合はERR_BAD_PARAMETERです。
+void PreparedQuery::BindData(const int index, const Data value, const string text)
+{
+	if (index < 1 || static_cast<int>(parameters.size()) < index){
+		throw ResultValue::ERR_BAD_PARAMETER;
+	}
+	parameters[index - 1] = value;
+	strings[index - 1] = text;
+	bound[index - 1] = true;
+}
+
+//! パラメータの名前から番号を取得します。
+//! @param [in] name パラメータの名前です。先頭の:は含みません。
+//! @return パラメータの1から始まる番号です。
+//! @exception ResultValue 名前に対応するパラメータが存在しない場合はERR_BAD_PARAMETERです。
+int PreparedQuery::FindParameter(const string name) const
+{
+	auto &names = query.GetParameterNames();
+	auto found = name.empty() ? names.end() : find(names.begin(), names.end(), name);
+	if (found == names.end()){
+		throw ResultValue::ERR_BAD_PARAMETER;
+	}
+	return found - names.begin() + 1;
+}
+
+//! 番号で指定したパラメータに整数の値を設定します。
+//! @param [in] index 値を設定するパラメータの、1から始まる番号です。
+//! @param [in] value 設定する値です。
+void PreparedQuery::Bind(const int index, const int value)
+{
+	BindData(index, Data(value));
+}
+
+//! 番号で指定したパラメータに文字列の値を設定します。
+//! @param [in] index 値を設定するパラメータの、1から始まる番号です。
+//! @param [in] value 設定する値です。
+void PreparedQuery::Bind(const int index, const string value)
+{
+	BindData(index, Data(string_view()), value);
+}
+
+//! 名前で指定したパラメータに整数の値を設定します。
+//! @param [in] name 値を設定するパラメータの名前です。先頭の:は含みません。
+//! @param [in] value 設定する値です。
+void PreparedQuery::Bind(const string name, const int value)
+{
+	BindData(FindParameter(name), Data(value));
+}
+
+//! 名前で指定したパラメータに文字列の値を設定します。
+//! @param [in] name 値を設定するパラメータの名前です。先頭の:は含みません。
+//! @param [in] value 設定する値です。
+void PreparedQuery::Bind(const string name, const string value)
+{
+	BindData(FindParameter(name), Data(string_view()), value);
+}
+
+//! 設定されたパラメータの値でSQLを実行し、結果をファイルに出力します。
+//! @param [in] outputFileName SQLの実行結果をCSVとして出力するファイル名です。拡張子を含みます。
+//! @return 実行した結果の状態です。ExecuteSQLと同じ値を返し、値が設定されていないパラメータがある場合はERR_BAD_PARAMETERです。
+int PreparedQuery::Execute(const string outputFileName) const
+{
+	if (find(bound.begin(), bound.end(), false) != bound.end()){
+		return static_cast<int>(ResultValue::ERR_BAD_PARAMETER);
+	}
+	// 長い文字列のデータは実体を参照するので、コピーしたインスタンスの文字列を指さないよう、実行ごとに作ります。
+	auto values = parameters; // 実行に使うパラメータの値です。
+	for (size_t i = 0; i < values.size(); ++i){
+		if (values[i].type() == DataType::STRING){
+			values[i] = Data(string_view(strings[i]));
+		}
+	}
+	try {
+		query.Execute(outputFileName, values);
+		return static_cast<int>(ResultValue::OK);
+	}
+	catch (ResultValue error) {
+		return static_cast<int>(error);
+	}
+}
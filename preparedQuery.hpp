@@ -0,0 +1,68 @@
+#pragma once
+
+#include "sqlQuery.hpp"
+#include "data.hpp"
+#include "resultValue.hpp"
+
+#include <string>
+#include <vector>
+
+//! 一度だけ解析したSQLを、WHERE句のパラメータの値を変えながら繰り返し実行するためのクラスです。
+//! パラメータはSQLの中に ? もしくは :名前 の形で書きます。?で書いたパラメータは先頭から1, 2, …の番号で、:名前で書いたパラメータは番号か名前で値を設定します。
+//! 同じ名前のパラメータを複数回書いた場合は、全て同じ値となります。
+//! コピーしたインスタンスは解析済みの構文情報を共有するので、スレッドごとにコピーしてパラメータを設定すれば、同時に実行できます。
+class PreparedQuery
+{
+	const SqlQuery query;          //!< 解析済みのSQLです。
+	std::vector<Data> parameters;  //!< パラメータに設定された値です。文字列の値はExecuteでstringsから作るので、型だけを表します。
+	std::vector<std::string> strings; //!< 同じインデックスのparametersに設定された文字列です。
+	std::vector<bool> bound;       //!< 同じインデックスのparametersに値が設定されたかどうかです。
+
+	//! パラメータに値を設定します。
+	//! @param [in] index 値を設定するパラメータの、1から始まる番号です。
+	//! @param [in] value 設定する値です。
+	//! @param [in] text 文字列の値を設定する場合は、その文字列です。
+	//! @exception ResultValue 番号に対応するパラメータが存在しない場合はERR_BAD_PARAMETERです。
+	void BindData(const int index, const Data value, const std::string text = std::string());
+
+	//! パラメータの名前から番号を取得します。
+	//! @param [in] name パラメータの名前です。先頭の:は含みません。
+	//! @return パラメータの1から始まる番号です。
+	//! @exception ResultValue 名前に対応するパラメータが存在しない場合はERR_BAD_PARAMETERです。
+	int FindParameter(const std::string name) const;
+
+public:
+	//! PreparedQueryクラスの新しいインスタンスを初期化します。
+	//! @param [in] sql 実行するSQLです。
+	//! @exception ResultValue SQLの解析に失敗した場合は、ExecuteSQLと同じ値で失敗の種類を表します。
+	PreparedQuery(const std::string sql);
+
+	//! 番号で指定したパラメータに整数の値を設定します。
+	//! @param [in] index 値を設定するパラメータの、1から始まる番号です。
+	//! @param [in] value 設定する値です。
+	//! @exception ResultValue 番号に対応するパラメータが存在しない場合はERR_BAD_PARAMETERです。
+	void Bind(const int index, const int value);
+
+	//! 番号で指定したパラメータに文字列の値を設定します。
+	//! @param [in] index 値を設定するパラメータの、1から始まる番号です。
+	//! @param [in] value 設定する値です。
+	//! @exception ResultValue 番号に対応するパラメータが存在しない場合はERR_BAD_PARAMETERです。
+	void Bind(const int index, const std::string value);
+
+	//! 名前で指定したパラメータに整数の値を設定します。
+	//! @param [in] name 値を設定するパラメータの名前です。先頭の:は含みません。
+	//! @param [in] value 設定する値です。
+	//! @exception ResultValue 名前に対応するパラメータが存在しない場合はERR_BAD_PARAMETERです。
+	void Bind(const std::string name, const int value);
+
+	//! 名前で指定したパラメータに文字列の値を設定します。
+	//! @param [in] name 値を設定するパラメータの名前です。先頭の:は含みません。
+	//! @param [in] value 設定する値です。
+	//! @exception ResultValue 名前に対応するパラメータが存在しない場合はERR_BAD_PARAMETERです。
+	void Bind(const std::string name, const std::string value);
+
+	//! 設定されたパラメータの値でSQLを実行し、結果をファイルに出力します。
+	//! @param [in] outputFileName SQLの実行結果をCSVとして出力するファイル名です。拡張子を含みます。
+	//! @return 実行した結果の状態です。ExecuteSQLと同じ値を返し、値が設定されていないパラメータがある場合はERR_BAD_PARAMETERです。
+	int Execute(const std::string outputFileName) const;
+};
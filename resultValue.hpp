@@ -12,5 +12,6 @@ enum class ResultValue : int {
 	ERR_WHERE_OPERAND_TYPE = 7, //!< 演算の左右の型が適切ではありません。
 	ERR_CSV_SYNTAX = 8,         //!< CSVの構文解析が失敗しました。
 	ERR_MEMORY_ALLOCATE = 9,    //!< メモリの取得に失敗しました。
-	ERR_MEMORY_OVER = 10        //!< 用意したメモリ領域の上限を超えました。
+	ERR_MEMORY_OVER = 10,       //!< 用意したメモリ領域の上限を超えました。
+	ERR_BAD_PARAMETER = 11      //!< 指定されたパラメータが存在しないか、パラメータに値が設定されていません。
 };
\ No newline at end of file
@@ -3,46 +3,25 @@
 #include "column_index.hpp"
 #include "sqlQueryInfo.hpp"
 #include "resultValue.hpp"
-#include "intLiteralReader.hpp"
-#include "stringLiteralReader.hpp"
-#include "keywordReader.hpp"
-#include "signReader.hpp"
-#include "identifierReader.hpp"
+#include "lexer.hpp"
+#include "planCache.hpp"
+#include "whereProgram.hpp"
+#include "csvChunk.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
 
 using namespace std;
 
+namespace {
+	atomic<size_t> minStreamBytes(SqlQuery::defaultMinStreamBytes); //!< ORDER句の無いクエリで、先頭のテーブルを出力しながら少しずつ読み込む、データ行の最小のバイト数です。
+}
+
 //! SqlQueryクラスの新しいインスタンスを初期化します。
 //! @param [in] sql 実行するSQLです。
 SqlQuery::SqlQuery(const string sql) :
-// 先頭から順に検索されるので、前方一致となる二つの項目は順番に気をつけて登録しなくてはいけません。
-	tokenReaders({
-		make_shared<IntLiteralReader>(),
-		make_shared<StringLiteralReader>(),
-		make_shared<KeywordReader>(TokenKind::AND, "AND"),
-		make_shared<KeywordReader>(TokenKind::ASC, "ASC"),
-		make_shared<KeywordReader>(TokenKind::BY, "BY"),
-		make_shared<KeywordReader>(TokenKind::DESC, "DESC"),
-		make_shared<KeywordReader>(TokenKind::FROM, "FROM"),
-		make_shared<KeywordReader>(TokenKind::ORDER, "ORDER"),
-		make_shared<KeywordReader>(TokenKind::OR, "OR"),
-		make_shared<KeywordReader>(TokenKind::SELECT, "SELECT"),
-		make_shared<KeywordReader>(TokenKind::WHERE, "WHERE"),
-		make_shared<SignReader>(TokenKind::GREATER_THAN_OR_EQUAL, ">="),
-		make_shared<SignReader>(TokenKind::LESS_THAN_OR_EQUAL, "<="),
-		make_shared<SignReader>(TokenKind::NOT_EQUAL, "<>"),
-		make_shared<SignReader>(TokenKind::ASTERISK, "*"),
-		make_shared<SignReader>(TokenKind::COMMA, ","),
-		make_shared<SignReader>(TokenKind::CLOSE_PAREN, ")"),
-		make_shared<SignReader>(TokenKind::DOT, "."),
-		make_shared<SignReader>(TokenKind::EQUAL, "="),
-		make_shared<SignReader>(TokenKind::GREATER_THAN, ">" ),
-		make_shared<SignReader>(TokenKind::LESS_THAN, "<"),
-		make_shared<SignReader>(TokenKind::MINUS, "-"),
-		make_shared<SignReader>(TokenKind::OPEN_PAREN, "("),
-		make_shared<SignReader>(TokenKind::PLUS, "+"),
-		make_shared<SignReader>(TokenKind::SLASH, "/"),
-		make_shared<IdentifierReader>(),
-	}),
 	operators({
 		{ TokenKind::ASTERISK, 1 },
 		{ TokenKind::SLASH, 1 },
@@ -55,17 +34,23 @@ SqlQuery::SqlQuery(const string sql) :
 		{ TokenKind::LESS_THAN_OR_EQUAL, 3 },
 		{ TokenKind::NOT_EQUAL, 3 },
 		{ TokenKind::AND, 4 },
-		{ TokenKind::OR, 5 }})
+		{ TokenKind::OR, 5 }}),
+	literalStrings(make_shared<StringBuffer>())
 {
 	auto tokens = GetTokens(sql);
-	queryInfo = AnalyzeTokens(*tokens);
+	auto key = Normalize(*tokens, literals, *literalStrings); // 構文情報のキャッシュのキーです。
+	queryInfo = PlanCache::Instance().Find(key);
+	if (!queryInfo){
+		queryInfo = AnalyzeTokens(*tokens);
+		PlanCache::Instance().Add(key, queryInfo);
+	}
 }
 
 //! 二つの文字列を、大文字小文字を区別せずに比較し、等しいかどうかです。
 //! @param [in] str1 比較される一つ目の文字列です。
 //! @param [in] str2 比較される二つ目の文字列です。
 //! @return 比較した結果、等しいかどうかです。
-bool SqlQuery::Equali(const string str1, const string str2)
+bool SqlQuery::Equali(const string &str1, const string &str2) const
 {
 	bool ret;
 
@@ -79,47 +64,61 @@ bool SqlQuery::Equali(const string str1, const string str2)
 }
 
 //! @param [in] sql トークンに分解する元となるSQLです。
-//! @return 切り出されたトークンです。
-const shared_ptr<vector<Token>> SqlQuery::GetTokens(const string sql) const
+//! @return 切り出されたトークンです。末尾には種類がNOT_TOKENの番兵が置かれます。トークンはsqlを参照するので、sqlより長く使うことはできません。
+const shared_ptr<vector<Token>> SqlQuery::GetTokens(const string &sql) const
 {
-	auto cursol = sql.begin(); // SQLをトークンに分割して読み込む時に現在読んでいる文字の場所を表します。
-	auto end = sql.end(); // sqlのendを指します。
-
 	auto tokens = make_shared<vector<Token>>(); //読み込んだトークンです。
+	// 多くのSQLではトークンは区切りを含めて平均二文字以上になるので、その見積もりで一度だけ領域を確保します。見積もりを超えた場合は、vectorが拡張します。
+	tokens->reserve(sql.size() / 2 + 1);
+	Lexer::Instance().Tokenize(sql, *tokens);
 
-	// SQLをトークンに分割て読み込みます。
-	while (cursol != end){
+	// 構文解析で最後のトークンの先を読んでも安全なように、末尾に番兵を置きます。
+	tokens->push_back(Token(TokenKind::NOT_TOKEN));
 
-		// 空白を読み飛ばします。
-		cursol = find_if(cursol, end, [&](char c){return space.find(c) == string::npos;});
-		if (cursol == end) {
-			break;
-		}
+	return tokens;
+}
 
-		// 各種トークンを読み込み
-		shared_ptr<const Token> token;
-		if (any_of(tokenReaders.begin(), tokenReaders.end(),
-			[&](const shared_ptr<const TokenReader>& reader) {
-				return token = reader->Read(cursol, end);
-			})) {
-				tokens->push_back(*token);
+//! 構文情報のキャッシュのキーとなる、正規化したSQLを作成します。リテラルはキーに含めず、値を取り出します。
+//! キーワードは大文字で、空白は取り除かれた形となるので、キーワードの大文字小文字や空白の違いは同じキーとなります。
+//! @param [in] tokens 正規化の対象となるトークンです。末尾に番兵を含みます。
+//! @param [out] literalValues 取り出したリテラルの値を、書かれた順に設定します。
+//! @param [out] strings literalValuesの長い文字列の実体を格納する領域です。
+//! @return 正規化したSQLです。
+string SqlQuery::Normalize(const vector<Token> &tokens, vector<Data> &literalValues, StringBuffer &strings) const
+{
+	string key;
+	for (auto token = tokens.begin(); token != tokens.end() - 1; ++token){
+		// トークンの種類と、リテラル以外はその文字列を、区切り文字で区切って並べます。
+		key += static_cast<char>(token->kind);
+		if (token->kind == TokenKind::INT_LITERAL){
+			try {
+				literalValues.push_back(Data(stoi(string(token->word))));
+			}
+			catch (out_of_range&) {
+				throw ResultValue::ERR_TOKEN_CANT_READ;
+			}
 		}
-		else {
-			throw ResultValue::ERR_TOKEN_CANT_READ;
+		else if (token->kind == TokenKind::STRING_LITERAL){
+			// 前後のシングルクォートを取り去った文字列をデータとして読み込みます。
+			literalValues.push_back(Data(token->word.substr(1, token->word.size() - 2), strings));
 		}
+		else{
+			key.append(token->word);
+		}
+		key += '\0';
 	}
-
-	return tokens;
+	return key;
 }
 
 //! トークンを解析してSQLの構文で指定された情報を取得します。
-//! @param [in] tokens 解析の対象となるトークンです。
+//! @param [in] tokens 解析の対象となるトークンです。末尾に番兵を含みます。
 //! @return 解析した結果の情報です。
 const shared_ptr<const SqlQueryInfo> SqlQuery::AnalyzeTokens(const vector<Token> &tokens) const
 {
 	auto queryInfo = make_shared<SqlQueryInfo>();
 	// トークン列を解析し、構文を読み取ります。
 	auto tokenCursol = tokens.begin();
+	auto tokensEnd = tokens.end() - 1; // 番兵を除いたトークンの終わりです。
 	bool readOrder = false; // すでにORDER句が読み込み済みかどうかです
 	bool readWhere = false; // すでにWHERE句が読み込み済みかどうかです。
 	bool first = true; // FROM句の最初のテーブル名を読み込み中かどうかです。
@@ -146,13 +145,13 @@ const shared_ptr<const SqlQueryInfo> SqlQuery::AnalyzeTokens(const vector<Token>
 			}
 			if (tokenCursol->kind == TokenKind::IDENTIFIER){
 				// テーブル名が指定されていない場合と仮定して読み込みます。
-				queryInfo->selectColumns.push_back(Column(tokenCursol->word.c_str()));
+				queryInfo->selectColumns.push_back(Column(string(tokenCursol->word)));
 				++tokenCursol;
 				if (tokenCursol->kind == TokenKind::DOT){
 					++tokenCursol;
 					if (tokenCursol->kind == TokenKind::IDENTIFIER){
 						// テーブル名が指定されていることがわかったので読み替えます。
-						queryInfo->selectColumns.back() = Column(queryInfo->selectColumns.back().columnName, tokenCursol->word);
+						queryInfo->selectColumns.back() = Column(queryInfo->selectColumns.back().columnName, string(tokenCursol->word));
 						++tokenCursol;
 					}
 					else{
@@ -194,13 +193,13 @@ const shared_ptr<const SqlQueryInfo> SqlQuery::AnalyzeTokens(const vector<Token>
 					}
 					if (tokenCursol->kind == TokenKind::IDENTIFIER){
 						// テーブル名が指定されていない場合と仮定して読み込みます。
-						queryInfo->orderByColumns.push_back(Column(tokenCursol->word));
+						queryInfo->orderByColumns.push_back(Column(string(tokenCursol->word)));
 						++tokenCursol;
 						if (tokenCursol->kind == TokenKind::DOT){
 							++tokenCursol;
 							if (tokenCursol->kind == TokenKind::IDENTIFIER) {
 								// テーブル名が指定されていることがわかったので読み替えます。
-								queryInfo->orderByColumns.back() = Column(queryInfo->orderByColumns.back().columnName, tokenCursol->word);
+								queryInfo->orderByColumns.back() = Column(queryInfo->orderByColumns.back().columnName, string(tokenCursol->word));
 								++tokenCursol;
 							}
 							else{
@@ -237,147 +236,11 @@ const shared_ptr<const SqlQueryInfo> SqlQuery::AnalyzeTokens(const vector<Token>
 		if (tokenCursol->kind == TokenKind::WHERE){
 			readWhere = true;
 			++tokenCursol;
-			shared_ptr<ExtensionTreeNode> currentNode; // 現在読み込んでいるノードです。
-			while (true){
-				// オペランドを読み込みます。
-
-				// オペランドのノードを新しく生成します。
-				queryInfo->whereExtensionNodes.push_back(make_shared<ExtensionTreeNode>());
-				if (currentNode){
-					// 現在のノードを右の子にずらし、元の位置に新しいノードを挿入します。
-					currentNode->right = queryInfo->whereExtensionNodes.back();
-					currentNode->right->parent = currentNode;
-					currentNode = currentNode->right;
-				}
-				else{
-					// 最初はカレントノードに新しいノードを入れます。
-					currentNode = queryInfo->whereExtensionNodes.back();
-				}
-
-				// カッコ開くを読み込みます。
-				while (tokenCursol->kind == TokenKind::OPEN_PAREN){
-					++currentNode->parenOpenBeforeClose;
-					++tokenCursol;
-				}
-
-				// オペランドに前置される+か-を読み込みます。
-				if (tokenCursol->kind == TokenKind::PLUS || tokenCursol->kind == TokenKind::MINUS){
-
-					// +-を前置するのは列名と数値リテラルのみです。
-					if (tokenCursol[1].kind != TokenKind::IDENTIFIER && tokenCursol[1].kind != TokenKind::INT_LITERAL){
-						throw ResultValue::ERR_WHERE_OPERAND_TYPE;
-					}
-					if (tokenCursol->kind == TokenKind::MINUS){
-						currentNode->signCoefficient = -1;
-					}
-					++tokenCursol;
-				}
-
-				// 列名、整数リテラル、文字列リテラルのいずれかをオペランドとして読み込みます。
-				if (tokenCursol->kind == TokenKind::IDENTIFIER){
-
-					// テーブル名が指定されていない場合と仮定して読み込みます。
-					currentNode->column = Column(tokenCursol->word);
-					++tokenCursol;
-					if (tokenCursol->kind == TokenKind::DOT){
-						++tokenCursol;
-						if (tokenCursol->kind == TokenKind::IDENTIFIER){
-
-							// テーブル名が指定されていることがわかったので読み替えます。
-							currentNode->column = Column(currentNode->column.columnName, tokenCursol->word);
-							++tokenCursol;
-						}
-						else{
-							throw ResultValue::ERR_SQL_SYNTAX;
-						}
-					}
-				}
-				else if (tokenCursol->kind == TokenKind::INT_LITERAL){
-					currentNode->value = Data(stoi(tokenCursol->word));
-					++tokenCursol;
-				}
-				else if (tokenCursol->kind == TokenKind::STRING_LITERAL){
-					// 前後のシングルクォートを取り去った文字列をデータとして読み込みます。
-					currentNode->value = Data(string(tokenCursol->word).substr(1, string(tokenCursol->word).size() - 2));
-
-					++tokenCursol;
-				}
-				else{
-					throw ResultValue::ERR_SQL_SYNTAX;
-				}
 
-				// オペランドの右のカッコ閉じるを読み込みます。
-				while (tokenCursol->kind == TokenKind::CLOSE_PAREN){
-					shared_ptr<ExtensionTreeNode> searchedAncestor = currentNode->parent; // カッコ閉じると対応するカッコ開くを両方含む祖先ノードを探すためのカーソルです。
-					while (searchedAncestor){
-
-						// searchedAncestorの左の子に対応するカッコ開くがないかを検索します。
-						shared_ptr<ExtensionTreeNode> searched = searchedAncestor; // searchedAncestorの内部からカッコ開くを検索するためのカーソルです。
-						while (searched && !searched->parenOpenBeforeClose){
-							searched = searched->left;
-						}
-						if (searched){
-							// 対応付けられていないカッコ開くを一つ削除し、ノードがカッコに囲まれていることを記録します。
-							--searched->parenOpenBeforeClose;
-							searchedAncestor->inParen = true;
-							break;
-						}
-						else{
-							searchedAncestor = searchedAncestor->parent;
-						}
-					}
-					++tokenCursol;
-				}
-
-				// 演算子(オペレーターを読み込みます。
-				auto foundOperator = find_if(operators.begin(), operators.end(), [&](const Operator& op){ return op.kind == tokenCursol->kind; });
-
-				// 現在見ている演算子の情報を探します。
-				if (foundOperator != operators.end()) {
-					// 見つかった演算子の情報をもとにノードを入れ替えます。
-					shared_ptr<ExtensionTreeNode> tmp = currentNode; //ノードを入れ替えるために使う変数です。
-					shared_ptr<ExtensionTreeNode> searched = tmp; // 入れ替えるノードを探すためのカーソルです。
-
-					//カッコにくくられていなかった場合に、演算子の優先順位を参考に結合するノードを探します。
-					bool first = true; // 演算子の優先順位を検索する最初のループです。
-					do{
-						if (!first){
-							tmp = tmp->parent;
-							searched = tmp;
-						}
-						// 現在の読み込み場所をくくるカッコが開く場所を探します。
-						while (searched && !searched->parenOpenBeforeClose){
-							searched = searched->left;
-						}
-						first = false;
-					} while (!searched && tmp->parent && (tmp->parent->middleOperator.order <= foundOperator->order || tmp->parent->inParen));
-
-					// 演算子のノードを新しく生成します。
-					queryInfo->whereExtensionNodes.push_back(make_shared<ExtensionTreeNode>());
-					currentNode = queryInfo->whereExtensionNodes.back();
-					currentNode->middleOperator = *foundOperator;
-
-					// 見つかった場所に新しいノードを配置します。これまでその位置にあったノードは左の子となるよう、親ノードと子ノードのポインタをつけかえます。
-					currentNode->parent = tmp->parent;
-					if (currentNode->parent){
-						currentNode->parent->right = currentNode;
-					}
-					currentNode->left = tmp;
-					tmp->parent = currentNode;
-
-					++tokenCursol;
-				}
-				else{
-					// 現在見ている種類が演算子の一覧から見つからなければ、WHERE句は終わります。
-					break;
-				}
-			}
-
-			// 木を根に向かってさかのぼり、根のノードを設定します。
-			queryInfo->whereTopNode = currentNode;
-			while (queryInfo->whereTopNode->parent){
-				queryInfo->whereTopNode = queryInfo->whereTopNode->parent;
-			}
+			// ノードは一つ以上のトークンから作られるので、残りのトークン数を上限としてノードの領域をまとめて確保します。
+			// ノードはこの領域にだけ置かれ、インデックスで互いを参照するので、SqlQueryInfoの破棄とともに一度に解放されます。
+			queryInfo->whereExtensionNodes.reserve(tokensEnd - tokenCursol);
+			queryInfo->whereTopNode = ReadWhereExpression(tokenCursol, *queryInfo);
 		}
 	}
 
@@ -390,12 +253,12 @@ const shared_ptr<const SqlQueryInfo> SqlQuery::AnalyzeTokens(const vector<Token>
 	}
 
 	first = true; // FROM句の最初のテーブル名を読み込み中かどうかです。
-	while (tokenCursol != tokens.end() && tokenCursol->kind == TokenKind::COMMA || first){
+	while (tokenCursol != tokensEnd && tokenCursol->kind == TokenKind::COMMA || first){
 		if (tokenCursol->kind == TokenKind::COMMA){
 			++tokenCursol;
 		}
 		if (tokenCursol->kind == TokenKind::IDENTIFIER){
-			queryInfo->tableNames.push_back(tokenCursol->word);
+			queryInfo->tableNames.push_back(string(tokenCursol->word));
 			++tokenCursol;
 		}
 		else{
@@ -405,432 +268,948 @@ const shared_ptr<const SqlQueryInfo> SqlQuery::AnalyzeTokens(const vector<Token>
 	}
 
 	// 最後のトークンまで読み込みが進んでいなかったらエラーです。
-	if (tokenCursol != tokens.end()) {
+	if (tokenCursol != tokensEnd) {
 		throw ResultValue::ERR_SQL_SYNTAX;
 	}
 
 	return queryInfo;
 }
 
+//! WHERE句の式を読み込みます。演算子とカッコの開始をスタックに積みながら、各トークンを一度だけ読んで木を構築します。
+//! 再帰せずに読み込むので、カッコや演算子がどれだけ深く入れ子になっていても、呼び出しのスタックは溢れません。
+//! @param [in] tokenCursol 読み込み開始位置です。読み込んだ式の次の位置に進めます。
+//! @param [in] queryInfo 読み込んだノードを追加する先です。
+//! @return 読み込んだ式の根となるノードの、whereExtensionNodesでのインデックスです。
+//! @exception ResultValue カッコが閉じられていない場合はERR_SQL_SYNTAXです。
+int SqlQuery::ReadWhereExpression(vector<Token>::const_iterator &tokenCursol, SqlQueryInfo &queryInfo) const
+{
+	vector<int> operands; // 読み込み済みで、まだ演算子のノードの子になっていない式です。
+	vector<const Operator*> pendingOperators; // 右側の式を読み込み中の演算子です。nullptrはカッコの開始を表します。
+	int openParens = 0; // 閉じられていないカッコの数です。
+
+	// スタックの先頭の演算子のノードを新しく生成し、最後の二つの式を左右の子とします。
+	auto reduce = [&]() {
+		int right = operands.back();
+		operands.pop_back();
+		int left = operands.back();
+		queryInfo.whereExtensionNodes.push_back(ExtensionTreeNode());
+		int node = queryInfo.whereExtensionNodes.size() - 1;
+		queryInfo.whereExtensionNodes[node].middleOperator = *pendingOperators.back();
+		queryInfo.whereExtensionNodes[node].left = left;
+		queryInfo.whereExtensionNodes[node].right = right;
+		queryInfo.whereExtensionNodes[left].parent = node;
+		queryInfo.whereExtensionNodes[right].parent = node;
+		operands.back() = node;
+		pendingOperators.pop_back();
+	};
+
+	while (true){
+		// カッコの開始を読み込んでから、オペランドを読み込みます。
+		while (tokenCursol->kind == TokenKind::OPEN_PAREN){
+			pendingOperators.push_back(nullptr);
+			++openParens;
+			++tokenCursol;
+		}
+		operands.push_back(ReadWhereOperand(tokenCursol, queryInfo));
+
+		// カッコの終了を読み込み、カッコの中の式を一つのオペランドとします。
+		while (openParens && tokenCursol->kind == TokenKind::CLOSE_PAREN){
+			while (pendingOperators.back()){
+				reduce();
+			}
+			pendingOperators.pop_back();
+			--openParens;
+			queryInfo.whereExtensionNodes[operands.back()].inParen = true;
+			++tokenCursol;
+		}
+
+		// 演算子(オペレーターを読み込みます。
+		auto foundOperator = find_if(operators.begin(), operators.end(), [&](const Operator& op){ return op.kind == tokenCursol->kind; });
+
+		// 現在見ている種類が演算子の一覧から見つからなければ、この式は終わります。
+		if (foundOperator == operators.end()){
+			break;
+		}
+		++tokenCursol;
+
+		// 見つかった演算子より強く結合するか、同じ優先順位の演算子は、左から結合するので先にノードにします。
+		while (!pendingOperators.empty() && pendingOperators.back() && pendingOperators.back()->order <= foundOperator->order){
+			reduce();
+		}
+		pendingOperators.push_back(&*foundOperator);
+	}
+	if (openParens){
+		throw ResultValue::ERR_SQL_SYNTAX;
+	}
+	while (!pendingOperators.empty()){
+		reduce();
+	}
+	return operands.back();
+}
+
+//! WHERE句のオペランドを読み込みます。カッコはReadWhereExpressionが読み込みます。
+//! @param [in] tokenCursol 読み込み開始位置です。読み込んだオペランドの次の位置に進めます。
+//! @param [in] queryInfo 読み込んだノードを追加する先です。
+//! @return 読み込んだオペランドのノードの、whereExtensionNodesでのインデックスです。
+int SqlQuery::ReadWhereOperand(vector<Token>::const_iterator &tokenCursol, SqlQueryInfo &queryInfo) const
+{
+	// オペランドのノードを新しく生成します。
+	queryInfo.whereExtensionNodes.push_back(ExtensionTreeNode());
+	int node = queryInfo.whereExtensionNodes.size() - 1;
+	auto &operand = queryInfo.whereExtensionNodes[node];
+
+	// オペランドに前置される+か-を読み込みます。
+	if (tokenCursol->kind == TokenKind::PLUS || tokenCursol->kind == TokenKind::MINUS){
+
+		// +-を前置するのは列名、数値リテラル、パラメータのみです。
+		if (tokenCursol[1].kind != TokenKind::IDENTIFIER && tokenCursol[1].kind != TokenKind::INT_LITERAL && tokenCursol[1].kind != TokenKind::PARAMETER){
+			throw ResultValue::ERR_WHERE_OPERAND_TYPE;
+		}
+		if (tokenCursol->kind == TokenKind::MINUS){
+			operand.signCoefficient = -1;
+		}
+		++tokenCursol;
+	}
+
+	// 列名、整数リテラル、文字列リテラル、パラメータのいずれかをオペランドとして読み込みます。
+	if (tokenCursol->kind == TokenKind::IDENTIFIER){
+
+		// テーブル名が指定されていない場合と仮定して読み込みます。
+		operand.column = Column(string(tokenCursol->word));
+		++tokenCursol;
+		if (tokenCursol->kind == TokenKind::DOT){
+			++tokenCursol;
+			if (tokenCursol->kind == TokenKind::IDENTIFIER){
+
+				// テーブル名が指定されていることがわかったので読み替えます。
+				operand.column = Column(operand.column.columnName, string(tokenCursol->word));
+				++tokenCursol;
+			}
+			else{
+				throw ResultValue::ERR_SQL_SYNTAX;
+			}
+		}
+	}
+	else if (tokenCursol->kind == TokenKind::INT_LITERAL || tokenCursol->kind == TokenKind::STRING_LITERAL){
+		// リテラルの値は構文情報に含めず、何番目のリテラルかだけを記録します。
+		operand.literalIndex = queryInfo.literalCount++;
+		++tokenCursol;
+	}
+	else if (tokenCursol->kind == TokenKind::PARAMETER){
+		// ?で書かれたパラメータは毎回新しいインデックスを割り当て、:名前で書かれたパラメータは同じ名前であれば同じインデックスを割り当てます。
+		auto name = tokenCursol->word == "?" ? string() : string(tokenCursol->word.substr(1)); // 先頭の:を取り去ったパラメータの名前です。
+		auto &names = queryInfo.parameterNames;
+		auto found = name.empty() ? names.end() : find(names.begin(), names.end(), name);
+		if (found == names.end()){
+			names.push_back(name);
+			found = names.end() - 1;
+		}
+		operand.parameterIndex = found - names.begin();
+		++tokenCursol;
+	}
+	else{
+		throw ResultValue::ERR_SQL_SYNTAX;
+	}
+	return node;
+}
+
 //! CSVファイルから入力データを読み取ります。
-//! @return ファイルから読み取ったデータです。
-const shared_ptr<const vector<InputTable>> SqlQuery::ReadCsv() const
+//! 全てのファイルのヘッダ行を読んでから、SELECT句、WHERE句、ORDER句で参照される列だけの値を読み込みます。参照されない列の値は読み飛ばし、行の数だけを数えます。
+//! WHERE句の最上位のANDで区切った条件のうち、一つのテーブルの列だけを参照する条件は、そのテーブルを読む際に評価し、条件に合う行だけを読み込みます。
+//! streamFirstがtrueで、先頭のテーブルのデータ行がMinStreamBytes以上の場合は、全ての値から列の型だけを求め、値はWriteCsvで出力しながら少しずつ読み込みます。
+//! ColumnarFileが有効な場合は、各テーブルをサイドカーファイルから読み込みます。サイドカーファイルが無いか古い場合は、CSVファイルから作成してから読み込みます。
+//! TableCacheの上限が0でない場合は、キャッシュにあるテーブルは値を読まずにキャッシュの値を参照し、上限に収まる大きさのテーブルはキャッシュに追加してから参照します。
+//! 読み込んでもキャッシュに追加されなかったテーブルは、CSVファイルが変わるまで他のテーブルと同じように読み込みます。
+//! @param [in] parameters WHERE句のパラメータに設定する値です。
+//! @param [in] streamFirst 先頭のテーブルの値を読み込まずに残してよいかどうかです。
+//! @param [in] arena 読み取ったデータの領域を切り出すArenaです。
+//! @param [in] pool 文字列の値に番号を振るプールです。nullptrの場合は番号を振りません。
+//! @return ファイルから読み取ったデータです。参照されない列のvaluesは空です。先頭のテーブルの値を残した場合は、そのvaluesは値を持たずに型だけを持ち、pendingRowsが残したデータ行を参照します。
+//! キャッシュの値を参照するテーブルは、valuesを持たずにsharedを設定し、WHERE句の条件で絞り込みません。
+//! @exception ResultValue 参照する列が無いか、複数ある場合はERR_BAD_COLUMN_NAMEです。評価した条件の型が適切ではない場合はERR_WHERE_OPERAND_TYPEです。
+const shared_ptr<vector<InputTable>> SqlQuery::ReadCsv(const vector<Data> &parameters, const bool streamFirst, Arena &arena, StringPool *pool) const
 {
 	auto ret = make_shared<vector<InputTable>>();
 	auto &tables = *ret;
-	vector<ifstream> inputTableFiles; // 読み込む入力ファイルの全てのファイルポインタです。
+	vector<const char*> dataStarts; // 各入力ファイルの、データ行の先頭です。
+	auto cacheBudget = TableCache::Instance().Budget(); // テーブルを保持するキャッシュの大きさの上限です。0の場合はキャッシュを使いません。
+	vector<string> cacheKeys; // 各入力ファイルの、キャッシュに追加する際のキーです。キャッシュに追加しない場合は空文字列です。
 
 	for (size_t i = 0; i < queryInfo->tableNames.size(); ++i){
 		tables.push_back(InputTable());
 		auto &table = tables.back();
-		// 入力ファイルを開きます。
-		inputTableFiles.push_back(ifstream(queryInfo->tableNames[i] + ".csv"));
-		if (!inputTableFiles.back()) {
-			throw ResultValue::ERR_FILE_OPEN;
+		auto path = queryInfo->tableNames[i] + ".csv"; // 入力ファイルのパスです。
+		cacheKeys.push_back(cacheBudget ? TableCache::Canonicalize(path) : string());
+
+		// キャッシュにあるテーブルは、入力ファイルを開かずにキャッシュの値を参照します。
+		auto cached = cacheKeys.back().empty() ? nullptr : TableCache::Instance().Find(cacheKeys.back()); // キャッシュにあるテーブルです。
+		if (cached){
+			for (auto &column : cached->table.columns) {
+				table.columns.push_back(Column(queryInfo->tableNames[i], column.columnName));
+			}
+			table.rowCount = cached->table.rowCount;
+			table.shared = shared_ptr<const InputTable>(cached, &cached->table);
+			dataStarts.push_back(nullptr);
+			continue;
 		}
 
+		// 入力ファイルをマッピングします。文字列の値は複写せずにマッピングした領域を参照します。
+		table.file = MappedFile(path);
+		auto contents = table.file.Contents(); // 入力ファイルの内容です。
+		auto fileCursol = contents.data(); // 入力ファイルを読み進めるカーソルです。
+		auto fileEnd = contents.data() + contents.size(); // 入力ファイルのendを指します。
+
 		// 入力CSVのヘッダ行を読み込みます。
-		string inputLine; // ファイルから読み込んだ行文字列です。
-		if (getline(inputTableFiles.back(), inputLine)) {
-			auto charactorCursol = inputLine.begin();
-			auto lineEnd = inputLine.end();
-
-			// 読み込んだ行を最後まで読みます。
-			while (charactorCursol != lineEnd){
-				// 列名を一つ読みます。
-				auto columnStart = charactorCursol;
-				charactorCursol = find(charactorCursol, lineEnd, ',');
-				table.columns.push_back(Column(queryInfo->tableNames[i], string(columnStart, charactorCursol)));
-				// 入力行のカンマの分を読み進めます。
-				if (charactorCursol != lineEnd) {
-					++charactorCursol;
-				}
-			}
-		}
-		else{
+		if (fileCursol == fileEnd){
 			throw ResultValue::ERR_CSV_SYNTAX;
 		}
-
-		// 入力CSVのデータ行を読み込みます。
-		while (getline(inputTableFiles.back(), inputLine)) {
-			table.data.push_back(vector<Data>()); // 入力されている一行分のデータです。
-			vector<Data> &row = table.data.back();
-
-			auto charactorCursol = inputLine.begin(); // データ入力行を検索するカーソルです。
-			auto lineEnd = inputLine.end(); // データ入力行のendを指します。
-			
-			// 読み込んだ行を最後まで読みます。
-			while (charactorCursol != lineEnd){
-				auto columnStart  = charactorCursol; // 現在の列の最初を記録しておきます。
-				charactorCursol = find(charactorCursol, lineEnd, ',');
-				
-				row.push_back(Data(string(columnStart, charactorCursol)));
-
-				// 入力行のカンマの分を読み進めます。
-				if (charactorCursol != lineEnd) {
-					++charactorCursol;
-				}
+		auto headerNewLine = static_cast<const char*>(memchr(fileCursol, '\n', fileEnd - fileCursol)); // ヘッダ行の行末の改行文字の位置です。
+		auto headerEnd = headerNewLine ? headerNewLine : fileEnd; // ヘッダ行のendを指します。
+
+		// 読み込んだ行を最後まで読みます。
+		while (fileCursol != headerEnd){
+			// 列名を一つ読みます。
+			auto columnStart = fileCursol;
+			fileCursol = find(fileCursol, headerEnd, ',');
+			table.columns.push_back(Column(queryInfo->tableNames[i], string(columnStart, fileCursol)));
+			// 入力行のカンマの分を読み進めます。
+			if (fileCursol != headerEnd) {
+				++fileCursol;
 			}
 		}
+		dataStarts.push_back(headerNewLine ? headerNewLine + 1 : fileEnd);
+	}
 
-		// 全てが数値となる列は数値列に変換します。
-		for (size_t j = 0; j < table.columns.size(); ++j) {
-
-			// 全ての行のある列について、データ文字列から符号と数値以外の文字を探します。
+	auto referenced = FindReferencedColumns(tables); // テーブルごと、列ごとの、SQLで参照されるかどうかです。
 
-			// 符号と数字以外が見つからない列については、数値列に変換します。
-			// none_of：無該当の時に真を返す。
-			if (none_of(table.data.begin(), table.data.end(),
-				[&](const vector<Data> &inputRow) {
-					// any_of：条件式に部分一致すると真を返す。
-					return any_of(inputRow[j].string().begin(), inputRow[j].string().end(),
-						[&](const char& c) { return signNum.find(c) == string::npos; });
-				})) {
+	// 一つのテーブルの列だけを参照するWHERE句の条件は、そのテーブルを読む際に評価します。
+	auto whereColumnIndexes = BindWhereColumns(tables); // WHERE句の各ノードに対応する列の、入力ファイルとしてのインデックスです。
+	vector<vector<int>> pushedConjuncts(tables.size()); // テーブルごとの、読む際に評価する条件です。
+	for (auto conjunct : WhereProgram::SplitConjuncts(*queryInfo)) {
+		auto table = FindConjunctTable(conjunct, whereColumnIndexes); // 条件が参照するテーブルです。
+		if (0 <= table){
+			pushedConjuncts[table].push_back(conjunct);
+		}
+	}
 
-				// 符号と数字以外が見つからない列については、数値列に変換します。
-				for (auto& inputRow : table.data) {
-					inputRow[j] = Data(stoi(inputRow[j].string()));
+	for (size_t i = 0; i < tables.size(); ++i){
+		auto &table = tables[i];
+		if (table.shared){
+			continue;
+		}
+		auto &isReferenced = referenced[i]; // 列ごとの、SQLで参照されるかどうかです。
+		auto fileCursol = dataStarts[i]; // データ行の先頭です。
+		auto contents = table.file.Contents(); // 入力ファイルの内容です。
+		auto fileEnd = contents.data() + contents.size(); // 入力ファイルのendを指します。
+		auto columnCount = table.columns.size(); // ヘッダ行の列の数です。
+		if (!cacheKeys[i].empty() && static_cast<size_t>(fileEnd - fileCursol) <= cacheBudget &&
+			!TableCache::Instance().IsRejected(cacheKeys[i], contents.size(), table.file.Modified())){
+			// キャッシュに追加するテーブルは、絞り込まずに全ての列と全ての行を読み込み、キャッシュの値を参照します。
+			table.shared = CacheTable(table, fileCursol, cacheKeys[i]);
+			table.rowCount = table.shared->rowCount;
+			table.file = MappedFile();
+			continue;
+		}
+		table.values.reserve(columnCount);
+		if (ColumnarFile::IsEnabled()){
+			// サイドカーファイルがあれば、CSVファイルのデータ行を読まずに変換済みの値を読み込みます。
+			ColumnarFile columnar(queryInfo->tableNames[i] + ".csv" + ColumnarFile::extension, table.file, fileCursol, columnCount); // テーブルのサイドカーファイルです。
+			if (columnar.IsOpen()){
+				LoadColumnar(tables, i, columnar, isReferenced, pushedConjuncts[i], whereColumnIndexes, parameters, arena);
+				continue;
+			}
+		}
+		if (streamFirst && i == 0 && MinStreamBytes() <= static_cast<size_t>(fileEnd - fileCursol)){
+			// 出力しながら少しずつ読み込むテーブルは、列の型だけを求めてデータ行を残します。
+			AddTypedColumns(table, InferIntegerColumns(&table.file, fileCursol, fileEnd, isReferenced), arena);
+			table.pendingRows = string_view(fileCursol, fileEnd - fileCursol);
+			continue;
+		}
+		if (!pushedConjuncts[i].empty()){
+			// 列の型は条件に合わない行も含めた全ての値で判断するので、値を持たずに型だけを先に求めてから、読みながら絞り込みます。
+			// 絞り込んだ後もファイルの値を参照するので、型を求める際にページは外しません。
+			auto integerColumns = InferIntegerColumns(nullptr, fileCursol, fileEnd, isReferenced); // 列ごとの、全ての値が整数かどうかです。
+			FilterTable(tables, i, fileCursol, fileEnd, isReferenced, integerColumns, pushedConjuncts[i], whereColumnIndexes, parameters, arena, pool);
+			continue;
+		}
+		if (ChunkCount(fileEnd - fileCursol) == 1){
+			// 区切らない場合は、範囲ごとの結果を経由せずに列へ追加します。
+			for (size_t j = 0; j < columnCount; ++j){
+				table.values.emplace_back(arena, pool);
+			}
+			table.rowCount = CsvChunk::ForEachValue(fileCursol, fileEnd, columnCount, [&](const size_t column, const string_view value) {
+				if (isReferenced[column]){
+					table.values[column].AppendString(value);
 				}
+			});
+		}
+		else{
+			auto chunks = ParseChunks(fileCursol, fileEnd, isReferenced); // 範囲ごとに読み込んだ結果です。
+			AssignChunks(table, chunks, arena, pool);
+		}
+
+		// 全てが整数となる列は整数型の列に変換します。つなげた後の列の全ての値で判断します。
+		for (size_t j = 0; j < columnCount; ++j){
+			if (isReferenced[j]){
+				table.values[j].ConvertToInteger();
 			}
 		}
 	}
-	for (auto &inputTableFile : inputTableFiles) {
-		if (inputTableFile) {
-			inputTableFile.close();
-			if (inputTableFile.bad()) {
-				throw ResultValue::ERR_FILE_CLOSE;
+
+	// 番号を値の辞書順に振り直し、番号同士の大小で文字列を比較できるようにします。
+	if (pool){
+		auto ranks = pool->Sort(); // 元の番号ごとの、振り直した番号です。
+		for (auto &table : tables) {
+			for (auto &column : table.values) {
+				// サイドカーファイルの辞書のプールで番号を振った列は、既に辞書順の番号です。
+				if (column.pool == pool){
+					column.Recode(ranks);
+				}
 			}
 		}
 	}
 	return ret;
 }
 
-//! CSVファイルに出力データを書き込みます。
-void SqlQuery::WriteCsv(const string outputFileName, const vector<InputTable> &inputTables) const
+//! 入力CSVのデータ行を区切る範囲の数を求めます。範囲の数は、同時に実行できるスレッドの数を上限とし、範囲がminChunkBytesより小さくならない数です。
+//! @param [in] bytes データ行のバイト数です。
+//! @return 区切る範囲の数です。
+int SqlQuery::ChunkCount(const size_t bytes)
 {
-	SqlQueryInfo info = *queryInfo;
-	vector<Column> allInputColumns; // 入力に含まれるすべての列の一覧です。
-	vector<vector<vector<Data>>::const_iterator> currentRows; // 入力された各テーブルの、現在出力している行を指すカーソルです。
-	bool found;
-	vector<vector<Data>> outputData; // 出力データです。
-	vector<vector<Data>> allColumnOutputData; // 出力するデータに対応するインデックスを持ち、すべての入力データを保管します。
-	ofstream outputFile; // 書き込むファイルのファイルポインタです。
+	auto workers = max(1u, thread::hardware_concurrency()); // 同時に読み込む範囲の数の上限です。
+	return static_cast<int>(min<size_t>(workers, max<size_t>(1, bytes / minChunkBytes)));
+}
 
-	// 入力ファイルに書いてあったすべての列をallInputColumnsに設定します。
-	for (size_t i = 0; i < info.tableNames.size(); ++i){
-		transform(inputTables[i].columns.begin(), inputTables[i].columns.end(), back_inserter(allInputColumns),
-			[&](const Column& column) { return Column(info.tableNames[i], column.columnName); });
+//! 入力CSVのデータ行を、改行文字の直後で区切った範囲ごとに別のスレッドで読み込みます。
+//! @param [in] begin データ行の先頭です。
+//! @param [in] end データ行の終了位置です。
+//! @param [in] referenced ヘッダ行の列ごとの、値を読み込むかどうかです。
+//! @return 範囲ごとに読み込んだ結果です。ファイルでの順に並びます。
+vector<CsvChunk> SqlQuery::ParseChunks(const char *begin, const char *end, const vector<char> &referenced)
+{
+	auto chunkCount = ChunkCount(end - begin); // 区切る範囲の数です。
+	auto boundaries = CsvChunk::Split(begin, end, chunkCount); // 範囲の区切りの位置です。
+	vector<CsvChunk> chunks(chunkCount); // 範囲ごとに読み込んだ結果です。
+	vector<thread> threads; // 先頭以外の範囲を読み込むスレッドです。
+	for (int k = 1; k < chunkCount; ++k){
+		threads.emplace_back([&, k]() { chunks[k].Parse(boundaries[k], boundaries[k + 1], referenced); });
 	}
-
-	// SELECT句の列名指定が*だった場合は、入力CSVの列名がすべて選択されます。
-	if (info.selectColumns.empty()){
-		copy(allInputColumns.begin(), allInputColumns.end(), back_inserter(info.selectColumns));
+	chunks[0].Parse(boundaries[0], boundaries[1], referenced);
+	for (auto &worker : threads) {
+		worker.join();
 	}
+	return chunks;
+}
 
-	vector<Column> outputColumns;
+//! 出力しながら少しずつ読み込むテーブルの、一度に読み込むデータ行の終了位置を求めます。
+//! 一度に読み込む大きさは、並列に読み込む範囲の数の上限だけminChunkBytesを並べた大きさを目安とし、改行文字の直後で区切ります。
+//! @param [in] begin 読み込むデータ行の先頭です。
+//! @param [in] end データ行の終了位置です。
+//! @return 一度に読み込むデータ行の終了位置です。
+const char* SqlQuery::FindBatchEnd(const char *begin, const char *end)
+{
+	auto batchBytes = max(1u, thread::hardware_concurrency()) * minChunkBytes; // 一度に読み込むバイト数の目安です。
+	if (static_cast<size_t>(end - begin) <= batchBytes){
+		return end;
+	}
+	auto position = begin + batchBytes - 1; // この位置を含む行までを読み込みます。
+	auto newLine = static_cast<const char*>(memchr(position, '\n', end - position));
+	return newLine ? newLine + 1 : end;
+}
 
-	// SELECT句で指定された列名が、何個目の入力ファイルの何列目に相当するかを判別します。
-	vector<ColumnIndex> selectColumnIndexes; // SELECT句で指定された列の、入力ファイルとしてのインデックスです。
-	for (auto &selectColumn : info.selectColumns) {
-		found = false;
-		for (size_t i = 0; i < info.tableNames.size(); ++i){
-			int j = 0;
-			for (auto &inputColumn : inputTables[i].columns) {
-				if (Equali(selectColumn.columnName, inputColumn.columnName) &&
-					(selectColumn.tableName.empty() || // テーブル名が設定されている場合のみテーブル名の比較を行います。
-					//!*selectTableNameCursol && !*inputTableNameCursol)){
-					Equali(selectColumn.tableName, inputColumn.tableName))) {
-
-					// 既に見つかっているのにもう一つ見つかったらエラーです。
-					if (found){
-						throw ResultValue::ERR_BAD_COLUMN_NAME;
-					}
-					found = true;
-					// 見つかった値を持つ列のデータを生成します。
-					selectColumnIndexes.push_back(ColumnIndex(i, j));
+//! 入力CSVのデータ行の、全ての値が整数となる列を求めます。
+//! 値は列に持たずに、一度に読み込む大きさずつ、区切った範囲ごとに別のスレッドで調べます。fileを指定した場合は読み終えたページをメモリから外すので、ファイルの大きさによらない量のメモリで調べます。
+//! 整数ではない値が見つかった列は、以降は調べません。
+//! @param [in] file データ行を含む、マッピングした入力ファイルです。nullptrの場合は、ページを外さずに一度に全てのデータ行を調べます。
+//! @param [in] begin データ行の先頭です。
+//! @param [in] end データ行の終了位置です。
+//! @param [in] referenced ヘッダ行の列ごとの、SQLで参照されるかどうかです。
+//! @return 列ごとの、全ての値が整数かどうかです。参照されない列はfalseです。
+vector<char> SqlQuery::InferIntegerColumns(const MappedFile *file, const char *begin, const char *end, const vector<char> &referenced)
+{
+	auto integerColumns = referenced; // 列ごとの、調べた値が全て整数かどうかです。
+	auto cursol = begin; // 次に調べるデータ行の先頭です。
+	while (cursol != end && find(integerColumns.begin(), integerColumns.end(), true) != integerColumns.end()){
+		auto batchEnd = file ? FindBatchEnd(cursol, end) : end; // 一度に調べるデータ行の終了位置です。
+		auto chunkCount = ChunkCount(batchEnd - cursol); // 区切る範囲の数です。
+		auto boundaries = CsvChunk::Split(cursol, batchEnd, chunkCount); // 範囲の区切りの位置です。
+		vector<vector<char>> chunkIntegers(chunkCount, integerColumns); // 範囲ごと、列ごとの、値が全て整数かどうかです。
+
+		// 範囲の値を調べ、整数ではない値があった列を記録します。
+		auto inspect = [&](const int k) {
+			auto &integers = chunkIntegers[k];
+			CsvChunk::ForEachValue(boundaries[k], boundaries[k + 1], referenced.size(), [&](const size_t column, const string_view value) {
+				if (integers[column] && !ColumnValues::IsInteger(value)){
+					integers[column] = false;
 				}
-				++j;
+			});
+		};
+		vector<thread> threads; // 先頭以外の範囲を調べるスレッドです。
+		for (int k = 1; k < chunkCount; ++k){
+			threads.emplace_back(inspect, k);
+		}
+		inspect(0);
+		for (auto &worker : threads) {
+			worker.join();
+		}
+
+		// 全ての範囲で値が整数であった列だけを、整数となる列として残します。
+		for (auto &integers : chunkIntegers) {
+			for (size_t j = 0; j < integerColumns.size(); ++j){
+				integerColumns[j] = integerColumns[j] && integers[j];
 			}
 		}
+		if (file){
+			file->Discard(cursol, batchEnd);
+		}
+		cursol = batchEnd;
+	}
+	return integerColumns;
+}
 
-		// 一つも見つからなくてもエラーです。
-		if (!found){
-			throw ResultValue::ERR_BAD_COLUMN_NAME;
+//! 値を持たずに型だけを決めた列を、テーブルの全ての列として設定します。文字列型の列は番号で持ちません。
+//! WHERE句の条件を、値を読み込む前に命令列に変換するために使います。
+//! @param [in, out] table 列を設定するテーブルです。
+//! @param [in] integerColumns 列ごとの、整数型とするかどうかです。
+//! @param [in] arena 列の値の配列の領域を切り出すArenaです。
+void SqlQuery::AddTypedColumns(InputTable &table, const vector<char> &integerColumns, Arena &arena)
+{
+	table.values.clear();
+	for (auto integer : integerColumns) {
+		table.values.emplace_back(arena, nullptr);
+		if (integer){
+			table.values.back().type = DataType::INTEGER;
 		}
 	}
+}
 
-	// 出力する列名を設定します。
-	transform(selectColumnIndexes.begin(), selectColumnIndexes.end(), back_inserter(outputColumns),
-		[&](const ColumnIndex& index) {
-			return inputTables[index.table].columns[index.column];
-		});
+//! 範囲ごとに読み込んだデータ行を、ファイルでの順につなげてテーブルの値とします。列の型は変換しません。
+//! @param [in, out] table 値と行の数を設定するテーブルです。
+//! @param [in] chunks 範囲ごとに読み込んだ結果です。値は移動します。
+//! @param [in] arena 列の値の配列の領域を切り出すArenaです。
+//! @param [in] pool 文字列の値に番号を振るプールです。nullptrの場合は番号を振りません。
+void SqlQuery::AssignChunks(InputTable &table, vector<CsvChunk> &chunks, Arena &arena, StringPool *pool)
+{
+	auto columnCount = table.columns.size(); // ヘッダ行の列の数です。
+	table.values.clear();
+	table.rowCount = 0;
+	for (size_t j = 0; j < columnCount; ++j){
+		table.values.emplace_back(arena, pool);
+	}
+	for (auto &chunk : chunks) {
+		for (size_t j = 0; j < columnCount; ++j){
+			for (auto value : chunk.columns[j]) {
+				table.values[j].AppendString(value);
+			}
+		}
+		table.rowCount += chunk.rowCount;
+		chunk = CsvChunk();
+	}
+}
 
-	if (info.whereTopNode){
-		// 既存数値の符号を計算します。
-		for (auto &whereExtensionNode : info.whereExtensionNodes) {
-			if (whereExtensionNode->middleOperator.kind == TokenKind::NOT_TOKEN &&
-				whereExtensionNode->column.columnName.empty() &&
-				whereExtensionNode->value.type == DataType::INTEGER) {
-				whereExtensionNode->value = Data(whereExtensionNode->value.integer() * whereExtensionNode->signCoefficient);
+//! テーブルの全ての列と全ての行の値を、クエリの実行によらないCachedTableに読み込み、TableCacheに追加します。
+//! 文字列の値はCachedTableのプールで番号を振り、番号で持たない値はCachedTableのArenaに複写するので、入力ファイルのマッピングを参照しません。
+//! Arenaが上限を超えてTableCacheに追加されなかった場合も、読み込んだテーブルを返します。以降のクエリはTableCache::IsRejectedで判断し、このテーブルを読み込み直しません。
+//! @param [in] table ヘッダ行を読み取り、入力ファイルをマッピングしたテーブルです。
+//! @param [in] dataStart データ行の先頭です。
+//! @param [in] key 入力ファイルの正規化したパスです。
+//! @return 読み込んだテーブルです。使い終わるまでCachedTableを解放しません。
+shared_ptr<const InputTable> SqlQuery::CacheTable(const InputTable &table, const char *dataStart, const string &key)
+{
+	auto cached = make_shared<CachedTable>(); // 読み込むテーブルです。
+	auto &loaded = cached->table;
+	auto contents = table.file.Contents(); // 入力ファイルの内容です。
+	auto fileEnd = contents.data() + contents.size(); // 入力ファイルのendを指します。
+	loaded.columns = table.columns;
+	auto chunks = ParseChunks(dataStart, fileEnd, vector<char>(table.columns.size(), true)); // 範囲ごとに読み込んだ結果です。
+	AssignChunks(loaded, chunks, cached->arena, &cached->pool);
+	for (auto &column : loaded.values) {
+		if (column.ConvertToInteger()){
+			continue;
+		}
+		for (auto &value : column.strings) {
+			if (contents.data() <= value.data() && value.data() < fileEnd){
+				auto copy = static_cast<char*>(cached->arena.Allocate(value.size(), 1)); // Arenaに複写した値です。
+				memcpy(copy, value.data(), value.size());
+				value = string_view(copy, value.size());
 			}
 		}
 	}
 
-	transform(inputTables.begin(), inputTables.end(), back_inserter(currentRows),
-		[](const InputTable& table) {
-			return table.data.begin();
-		});
+	// 番号を値の辞書順に振り直します。番号はこのテーブルの中でだけ比較できます。
+	auto ranks = cached->pool.Sort(); // 元の番号ごとの、振り直した番号です。
+	for (auto &column : loaded.values) {
+		if (column.pool){
+			column.Recode(ranks);
+		}
+	}
+	cached->fileSize = contents.size();
+	cached->modified = table.file.Modified();
+	TableCache::Instance().Add(key, cached);
+	return shared_ptr<const InputTable>(cached, &loaded);
+}
 
-	// 出力するデータを設定します。
-	while (true){
-		outputData.push_back(vector<Data>());
-		vector<Data> &row = outputData.back(); // 出力している一行分のデータです。
+//! テーブルのデータ行を、範囲ごとに別のスレッドで読みながら、テーブルの列だけを参照するWHERE句の条件でbatchSize行ずつ絞り込み、条件に合う行だけをテーブルの値とします。
+//! 範囲ごとに、まとめて評価する行の値を持つ列と命令列を用意し、読んだ行がbatchSize行になるごとに評価します。条件に合わない行の値は、StringPoolに加えず、列にも持ちません。
+//! 先頭の範囲はarenaとpoolを使って条件に合う行の値をそのまま列に追加し、他の範囲の条件に合う行の値は、読み終えてからファイルでの順につなげます。
+//! @param [in, out] inputTables 入力データです。tableIndexのテーブルの値と行の数を設定します。
+//! @param [in] tableIndex 絞り込むテーブルのインデックスです。
+//! @param [in] begin データ行の先頭です。
+//! @param [in] end データ行の終了位置です。
+//! @param [in] referenced 列ごとの、SQLで参照されるかどうかです。
+//! @param [in] integerColumns 列ごとの、整数型の列とするかどうかです。テーブルの全ての行の値が整数である列です。
+//! @param [in] conjuncts 評価する条件の、式木の根のノードのインデックスです。
+//! @param [in] whereColumnIndexes WHERE句の各ノードに対応する列の、入力ファイルとしてのインデックスです。
+//! @param [in] parameters WHERE句のパラメータに設定する値です。
+//! @param [in] arena 読み取ったデータの領域を切り出すArenaです。
+//! @param [in] pool 文字列の値に番号を振るプールです。nullptrの場合は番号を振りません。
+//! @exception ResultValue 条件の型が適切ではない場合はERR_WHERE_OPERAND_TYPEです。
+void SqlQuery::FilterTable(vector<InputTable> &inputTables, const int tableIndex, const char *begin, const char *end, const vector<char> &referenced, const vector<char> &integerColumns,
+	const vector<int> &conjuncts, const vector<ColumnIndex> &whereColumnIndexes, const vector<Data> &parameters, Arena &arena, StringPool *pool) const
+{
+	auto chunkCount = ChunkCount(end - begin); // 区切る範囲の数です。
+	auto boundaries = CsvChunk::Split(begin, end, chunkCount); // 範囲の区切りの位置です。
+
+	// 型の誤りはスレッドを起動する前に検出するため、全ての範囲の列と命令列を先に用意します。
+	vector<unique_ptr<Arena>> chunkArenas; // 先頭以外の範囲の領域を切り出すArenaです。
+	vector<Arena*> arenas; // 範囲ごとの、領域を切り出すArenaです。
+	vector<vector<InputTable>> batchTables(chunkCount); // 範囲ごとの、まとめて評価する行の値を持つ入力データです。tableIndexのテーブルだけを使います。
+	vector<unique_ptr<WhereProgram>> programs; // 範囲ごとの、まとめた行を評価する命令列です。
+	vector<vector<ColumnValues>> selected(chunkCount); // 範囲ごとの、条件に合った行の値です。
+	for (int k = 0; k < chunkCount; ++k){
+		if (k == 0){
+			arenas.push_back(&arena);
+		}
+		else{
+			chunkArenas.push_back(make_unique<Arena>());
+			arenas.push_back(chunkArenas.back().get());
+		}
+		batchTables[k].resize(inputTables.size());
+		AddTypedColumns(batchTables[k][tableIndex], integerColumns, *arenas[k]);
+		programs.push_back(make_unique<WhereProgram>(*queryInfo, conjuncts, tableIndex, whereColumnIndexes, batchTables[k], literals, parameters, *arenas[k]));
+		for (auto integer : integerColumns) {
+			selected[k].emplace_back(*arenas[k], k == 0 ? pool : nullptr);
+			if (integer){
+				selected[k].back().type = DataType::INTEGER;
+			}
+		}
+	}
 
-		// 行の各列のデータを入力から持ってきて設定します。
-		transform(selectColumnIndexes.begin(), selectColumnIndexes.end(), back_inserter(row),
-			[&](const ColumnIndex& index) {
-				return (*currentRows[index.table])[index.column];
-			});
+	vector<int> rowCounts(chunkCount); // 範囲ごとの、条件に合った行の数です。
+	vector<thread> threads; // 先頭以外の範囲を読み込むスレッドです。
+	for (int k = 1; k < chunkCount; ++k){
+		threads.emplace_back([&, k]() {
+			rowCounts[k] = FilterChunk(boundaries[k], boundaries[k + 1], referenced, batchTables[k], tableIndex, *programs[k], *arenas[k], selected[k]);
+		});
+	}
+	rowCounts[0] = FilterChunk(boundaries[0], boundaries[1], referenced, batchTables[0], tableIndex, *programs[0], arena, selected[0]);
+	for (auto &worker : threads) {
+		worker.join();
+	}
 
-		allColumnOutputData.push_back(vector<Data>());
-		vector<Data> &allColumnsRow = allColumnOutputData.back();// WHEREやORDERのためにすべての情報を含む行。rowとインデックスを共有します。
-		for (auto &currentRow : currentRows) {
-			copy(currentRow->begin(), currentRow->end(), back_inserter(allColumnsRow));
+	// 先頭以外の範囲の値を、ファイルでの順に先頭の範囲の値につなげます。文字列の値はここでプールに加えます。
+	auto &table = inputTables[tableIndex];
+	table.values = move(selected[0]);
+	table.rowCount = rowCounts[0];
+	for (int k = 1; k < chunkCount; ++k){
+		for (size_t j = 0; j < table.values.size(); ++j){
+			auto &column = table.values[j];
+			auto &source = selected[k][j];
+			if (column.type == DataType::INTEGER){
+				column.integers.insert(column.integers.end(), source.integers.begin(), source.integers.end());
+			}
+			else{
+				for (auto value : source.strings) {
+					column.AppendString(value);
+				}
+			}
 		}
+		table.rowCount += rowCounts[k];
+	}
+}
 
-		// WHEREの条件となる値を再帰的に計算します。
-		if (info.whereTopNode){
-			shared_ptr<ExtensionTreeNode> currentNode = info.whereTopNode; // 現在見ているノードです。
-			while (currentNode){
-				// 子ノードの計算が終わってない場合は、まずそちらの計算を行います。
-				if (currentNode->left && !currentNode->left->calculated){
-					currentNode = currentNode->left;
-					continue;
+//! 範囲のデータ行を読みながら、batchSize行ずつまとめて条件で評価し、条件に合う行の値だけを列に追加します。
+//! まとめた行の値は評価し終えるごとに捨て、その領域を次の行に再利用するので、条件に合わない行の値は持ち続けません。
+//! @param [in] begin 範囲の先頭です。行の先頭である必要があります。
+//! @param [in] end 範囲の終了位置です。ファイルの末尾でなければ改行文字の直後である必要があります。
+//! @param [in] referenced 列ごとの、値を読み込むかどうかです。
+//! @param [in, out] batchTables tableIndexのテーブルに、まとめて評価する行の値を持つ、型を決めた列を持つ入力データです。
+//! @param [in] tableIndex 絞り込むテーブルのインデックスです。
+//! @param [in] conditions batchTablesのtableIndexのテーブルの行をまとめて評価する命令列です。
+//! @param [in] arena 評価に使う領域を切り出すArenaです。
+//! @param [in, out] selected 条件に合った行の値を追加する列です。
+//! @return 条件に合った行の数です。
+int SqlQuery::FilterChunk(const char *begin, const char *end, const vector<char> &referenced, vector<InputTable> &batchTables, const int tableIndex,
+	WhereProgram &conditions, Arena &arena, vector<ColumnValues> &selected)
+{
+	auto &batch = batchTables[tableIndex].values; // まとめて評価する行の値です。
+	auto columnCount = batch.size(); // ヘッダ行の列の数です。
+	vector<int> currentRows(batchTables.size()); // 評価する各テーブルの行です。まとめた行は常に先頭から並べるので0のままです。
+	ArenaVector<int> selection(WhereProgram::batchSize, 0, arena); // 条件に合った行の、まとめた最初の行からの位置です。
+	int batchRows = 0; // まとめた行の数です。
+	int selectedRows = 0; // 条件に合った行の数です。
+
+	// まとめた行を評価して条件に合う行の値を追加し、まとめた行の値を捨てます。
+	auto evaluate = [&]() {
+		int count = conditions.Execute(currentRows, batchRows, selection.data()); // 条件に合った行の数です。
+		for (size_t j = 0; j < columnCount; ++j){
+			if (!referenced[j]){
+				continue;
+			}
+			auto &source = batch[j];
+			auto &column = selected[j];
+			for (int k = 0; k < count; ++k){
+				if (source.type == DataType::INTEGER){
+					column.integers.push_back(source.integers[selection[k]]);
 				}
-				else if (currentNode->right && !currentNode->right->calculated){
-					currentNode = currentNode->right;
-					continue;
+				else{
+					column.AppendString(source.strings[selection[k]]);
 				}
+			}
+			source.integers.clear();
+			source.strings.clear();
+		}
+		selectedRows += count;
+		batchRows = 0;
+	};
+
+	CsvChunk::ForEachValue(begin, end, columnCount, [&](const size_t column, const string_view value) {
+		if (referenced[column]){
+			auto &values = batch[column];
+			if (values.type == DataType::INTEGER){
+				int integer = 0; // 整数に変換した値です。列の全ての値が整数であることは調べてあります。
+				ColumnValues::ParseInteger(value, integer);
+				values.integers.push_back(integer);
+			}
+			else{
+				values.strings.push_back(value);
+			}
+		}
+		if (column + 1 == columnCount && ++batchRows == WhereProgram::batchSize){
+			evaluate();
+		}
+	});
+	if (batchRows){
+		evaluate();
+	}
+	return selectedRows;
+}
 
-				// 自ノードの値を計算します。
-				switch (currentNode->middleOperator.kind){
-				case TokenKind::NOT_TOKEN:
-					// ノードにデータが設定されている場合です。
-
-					// データが列名で指定されている場合、今扱っている行のデータを設定します。
-					if (!currentNode->column.columnName.empty()){
-						found = false;
-						for (size_t i = 0; i < allInputColumns.size(); ++i){
-							if (Equali(currentNode->column.columnName, allInputColumns[i].columnName) &&
-								(currentNode->column.tableName.empty() || // テーブル名が設定されている場合のみテーブル名の比較を行います。
-								//!*whereTableNameCursol && !*allInputTableNameCursol)){
-								Equali(currentNode->column.tableName, allInputColumns[i].tableName))) {
-								// 既に見つかっているのにもう一つ見つかったらエラーです。
-								if (found){
-									throw ResultValue::ERR_BAD_COLUMN_NAME;
-								}
-								found = true;
-								currentNode->value = allColumnsRow[i];
-							}
-						}
-						// 一つも見つからなくてもエラーです。
-						if (!found){
-							throw ResultValue::ERR_BAD_COLUMN_NAME;
-						}
-						;
-						// 符号を考慮して値を計算します。
-						if (currentNode->value.type == DataType::INTEGER){
-							currentNode->value = Data(currentNode->value.integer() * currentNode->signCoefficient);
-						}
-					}
-					break;
-				case TokenKind::EQUAL:
-				case TokenKind::GREATER_THAN:
-				case TokenKind::GREATER_THAN_OR_EQUAL:
-				case TokenKind::LESS_THAN:
-				case TokenKind::LESS_THAN_OR_EQUAL:
-				case TokenKind::NOT_EQUAL:
-					// 比較演算子の場合です。
-
-					// 比較できるのは文字列型か整数型で、かつ左右の型が同じ場合です。
-					if (currentNode->left->value.type != DataType::INTEGER && currentNode->left->value.type != DataType::STRING ||
-						currentNode->left->value.type != currentNode->right->value.type){
-						throw ResultValue::ERR_WHERE_OPERAND_TYPE;
-					}
-					currentNode->value.type = DataType::BOOLEAN;
-
-					// 比較結果を型と演算子によって計算方法を変えて、計算します。
-					switch (currentNode->left->value.type){
-					case DataType::INTEGER:
-						switch (currentNode->middleOperator.kind){
-						case TokenKind::EQUAL:
-							currentNode->value = Data(currentNode->left->value.integer() == currentNode->right->value.integer());
-							break;
-						case TokenKind::GREATER_THAN:
-							currentNode->value = Data(currentNode->left->value.integer() > currentNode->right->value.integer());
-							break;
-						case TokenKind::GREATER_THAN_OR_EQUAL:
-							currentNode->value = Data(currentNode->left->value.integer() >= currentNode->right->value.integer());
-							break;
-						case TokenKind::LESS_THAN:
-							currentNode->value = Data(currentNode->left->value.integer() < currentNode->right->value.integer());
-							break;
-						case TokenKind::LESS_THAN_OR_EQUAL:
-							currentNode->value = Data(currentNode->left->value.integer() <= currentNode->right->value.integer());
-							break;
-						case TokenKind::NOT_EQUAL:
-							currentNode->value = Data(currentNode->left->value.integer() != currentNode->right->value.integer());
-							break;
-						}
-						break;
-					case DataType::STRING:
-						switch (currentNode->middleOperator.kind){
-						case TokenKind::EQUAL:
-							currentNode->value = Data(currentNode->left->value.string().c_str() == currentNode->right->value.string());
-							break;
-						case TokenKind::GREATER_THAN:
-							currentNode->value = Data(currentNode->left->value.string() > currentNode->right->value.string());
-							break;
-						case TokenKind::GREATER_THAN_OR_EQUAL:
-							currentNode->value = Data(currentNode->left->value.string() >= currentNode->right->value.string());
-							break;
-						case TokenKind::LESS_THAN:
-							currentNode->value = Data(currentNode->left->value.string() < currentNode->right->value.string());
-							break;
-						case TokenKind::LESS_THAN_OR_EQUAL:
-							currentNode->value = Data(currentNode->left->value.string() <= currentNode->right->value.string());
-							break;
-						case TokenKind::NOT_EQUAL:
-							currentNode->value = Data(currentNode->left->value.string() != currentNode->right->value.string());
-							break;
-						}
-						break;
-					}
-					break;
-				case TokenKind::PLUS:
-				case TokenKind::MINUS:
-				case TokenKind::ASTERISK:
-				case TokenKind::SLASH:
-					// 四則演算の場合です。
-
-					// 演算できるのは整数型同士の場合のみです。
-					if (currentNode->left->value.type != DataType::INTEGER || currentNode->right->value.type != DataType::INTEGER){
-						throw ResultValue::ERR_WHERE_OPERAND_TYPE;
-					}
-					currentNode->value.type = DataType::INTEGER;
-
-					// 比較結果を演算子によって計算方法を変えて、計算します。
-					switch (currentNode->middleOperator.kind){
-					case TokenKind::PLUS:
-						currentNode->value = Data(currentNode->left->value.integer() + currentNode->right->value.integer());
-						break;
-					case TokenKind::MINUS:
-						currentNode->value = Data(currentNode->left->value.integer() - currentNode->right->value.integer());
-						break;
-					case TokenKind::ASTERISK:
-						currentNode->value = Data(currentNode->left->value.integer() * currentNode->right->value.integer());
-						break;
-					case TokenKind::SLASH:
-						currentNode->value = Data(currentNode->left->value.integer() / currentNode->right->value.integer());
-						break;
-					}
-					break;
-				case TokenKind::AND:
-				case TokenKind::OR:
-					// 論理演算の場合です。
-
-					// 演算できるのは真偽値型同士の場合のみです。
-					if (currentNode->left->value.type != DataType::BOOLEAN || currentNode->right->value.type != DataType::BOOLEAN){
-						throw ResultValue::ERR_WHERE_OPERAND_TYPE;
-					}
-					currentNode->value.type = DataType::BOOLEAN;
+//! 一つのテーブルの行を、そのテーブルの列だけを参照する条件でbatchSize行ずつまとめて評価し、条件に合う行を求めます。
+//! @param [in] tableCount 入力するテーブルの数です。
+//! @param [in] tableIndex 評価するテーブルのインデックスです。
+//! @param [in] rowCount 評価するテーブルの行の数です。
+//! @param [in] conditions tableIndexのテーブルの行をまとめて評価する命令列です。
+//! @param [in] arena 評価に使う領域を切り出すArenaです。
+//! @return 条件に合った行です。昇順に並びます。
+vector<int> SqlQuery::SelectRows(const size_t tableCount, const int tableIndex, const int rowCount, WhereProgram &conditions, Arena &arena)
+{
+	vector<int> currentRows(tableCount); // 評価する各テーブルの行です。絞り込むテーブルの行だけを使います。
+	ArenaVector<int> selection(WhereProgram::batchSize, 0, arena); // 条件に合った行の、まとめて評価した最初の行からの位置です。
+	vector<int> selectedRows; // 条件に合った行です。
+	for (int batch = 0; batch < rowCount; batch += WhereProgram::batchSize){
+		int count = min<int>(WhereProgram::batchSize, rowCount - batch); // まとめて評価する行の数です。
+		currentRows[tableIndex] = batch;
+		int selected = conditions.Execute(currentRows, count, selection.data()); // 条件に合った行の数です。
+		for (int k = 0; k < selected; ++k){
+			selectedRows.push_back(batch + selection[k]);
+		}
+	}
+	return selectedRows;
+}
 
-					// 比較結果を演算子によって計算方法を変えて、計算します。
-					switch (currentNode->middleOperator.kind){
-					case TokenKind::AND:
-						currentNode->value = Data(currentNode->left->value.boolean() && currentNode->right->value.boolean());
-						break;
-					case TokenKind::OR:
-						currentNode->value = Data(currentNode->left->value.boolean() || currentNode->right->value.boolean());
-						break;
-					}
-				}
-				currentNode->calculated = true;
+//! サイドカーファイルからテーブルの値を読み込み、テーブルの列だけを参照するWHERE句の条件で絞り込みます。
+//! 列の型はサイドカーファイルに記録された、全ての行の値から判断した型です。値はサイドカーファイルをマッピングした領域を参照し、文字列に番号を振り直しません。
+//! @param [in, out] inputTables 入力データです。tableIndexのテーブルの値と行の数を設定し、fileをサイドカーファイルのマッピングに置き換えます。
+//! @param [in] tableIndex 読み込むテーブルのインデックスです。
+//! @param [in] columnar テーブルのCSVファイルに対応する、開いたサイドカーファイルです。
+//! @param [in] referenced 列ごとの、SQLで参照されるかどうかです。
+//! @param [in] conjuncts 評価する条件の、式木の根のノードのインデックスです。空の場合は全ての行を読み込みます。
+//! @param [in] whereColumnIndexes WHERE句の各ノードに対応する列の、入力ファイルとしてのインデックスです。
+//! @param [in] parameters WHERE句のパラメータに設定する値です。
+//! @param [in] arena 読み取ったデータの領域を切り出すArenaです。
+//! @exception ResultValue 条件の型が適切ではない場合はERR_WHERE_OPERAND_TYPEです。
+void SqlQuery::LoadColumnar(vector<InputTable> &inputTables, const int tableIndex, ColumnarFile &columnar, const vector<char> &referenced,
+	const vector<int> &conjuncts, const vector<ColumnIndex> &whereColumnIndexes, const vector<Data> &parameters, Arena &arena) const
+{
+	auto &table = inputTables[tableIndex];
+	columnar.Load(table, referenced, arena);
+	if (conjuncts.empty()){
+		return;
+	}
 
-				// 自身の計算が終わった後は親の計算に戻ります。
-				currentNode = currentNode->parent;
+	// 条件に合う行を求めます。辞書の番号は辞書順なので、番号で持つ列は番号同士で比較します。
+	WhereProgram conditions(*queryInfo, conjuncts, tableIndex, whereColumnIndexes, inputTables, literals, parameters, arena);
+	auto selectedRows = SelectRows(inputTables.size(), tableIndex, table.rowCount, conditions, arena); // 条件に合った行です。
+	int rowCount = selectedRows.size(); // 残す行の数です。
+
+	// 残す行だけを列に追加し直します。文字列の値と辞書はサイドカーファイルを参照したままです。
+	vector<ColumnValues> loaded; // サイドカーファイルから読み込んだ、全ての行の値です。
+	swap(loaded, table.values);
+	for (size_t j = 0; j < loaded.size(); ++j){
+		auto &source = loaded[j];
+		table.values.emplace_back(arena, source.pool);
+		auto &column = table.values.back();
+		column.type = source.type;
+		if (!referenced[j]){
+			continue;
+		}
+		if (source.type == DataType::INTEGER){
+			column.integers.reserve(rowCount);
+			for (auto row : selectedRows) {
+				column.integers.push_back(source.Integers()[row]);
 			}
-
-			// 条件に合わない行は出力から削除します。
-			if (!info.whereTopNode->value.boolean()){
-				allColumnOutputData.pop_back();
-				outputData.pop_back();
+		}
+		else if (source.pool){
+			column.codes.reserve(rowCount);
+			for (auto row : selectedRows) {
+				column.codes.push_back(source.Codes()[row]);
 			}
-			// WHERE条件の計算結果をリセットします。
-			for (auto &whereExtensionNode : info.whereExtensionNodes) {
-				whereExtensionNode->calculated = false;
+		}
+		else{
+			column.strings.reserve(rowCount);
+			for (auto row : selectedRows) {
+				column.strings.push_back(source.String(row));
 			}
 		}
+	}
+	table.rowCount = rowCount;
+}
 
-		// 各テーブルの行のすべての組み合わせを出力します。
+//! 列の指定が、何個目の入力ファイルの何列目に相当するかを判別します。
+//! @param [in] column 判別する列の指定です。
+//! @param [in] inputTables ファイルから読み取ったデータです。
+//! @return 列の入力ファイルとしてのインデックスです。
+//! @exception ResultValue 該当する列が無いか、複数ある場合はERR_BAD_COLUMN_NAMEです。
+ColumnIndex SqlQuery::BindColumn(const Column &column, const vector<InputTable> &inputTables) const
+{
+	bool found = false;
+	ColumnIndex ret;
+	for (size_t i = 0; i < inputTables.size(); ++i){
+		int j = 0;
+		for (auto &inputColumn : inputTables[i].columns) {
+			if (Equali(column.columnName, inputColumn.columnName) &&
+				(column.tableName.empty() || // テーブル名が設定されている場合のみテーブル名の比較を行います。
+				Equali(column.tableName, inputColumn.tableName))) {
+
+				// 既に見つかっているのにもう一つ見つかったらエラーです。
+				if (found){
+					throw ResultValue::ERR_BAD_COLUMN_NAME;
+				}
+				found = true;
+				ret = ColumnIndex(i, j);
+			}
+			++j;
+		}
+	}
 
-		// 最後のテーブルのカレント行をインクリメントします。
-		++currentRows[info.tableNames.size() - 1];
+	// 一つも見つからなくてもエラーです。
+	if (!found){
+		throw ResultValue::ERR_BAD_COLUMN_NAME;
+	}
+	return ret;
+}
 
-		// 最後のテーブルが最終行になっていた場合は先頭に戻し、順に前のテーブルのカレント行をインクリメントします。
-		for (int i = info.tableNames.size() - 1; currentRows[i] == inputTables[i].data.end() && 0 < i; --i){
-			++currentRows[i - 1];
-			currentRows[i] = inputTables[i].data.begin();
+//! SELECT句、WHERE句、ORDER句で参照される列を判別します。SELECT句の列名指定が*の場合は、全ての列が参照されます。
+//! @param [in] inputTables ヘッダ行を読み取った入力データです。
+//! @return テーブルごと、列ごとの、参照されるかどうかです。
+//! @exception ResultValue 参照する列が無いか、複数ある場合はERR_BAD_COLUMN_NAMEです。
+vector<vector<char>> SqlQuery::FindReferencedColumns(const vector<InputTable> &inputTables) const
+{
+	auto &info = *queryInfo; // 構文情報です。
+	vector<vector<char>> referenced; // テーブルごと、列ごとの、参照されるかどうかです。
+	for (auto &table : inputTables) {
+		referenced.push_back(vector<char>(table.columns.size(), info.selectColumns.empty()));
+	}
+
+	auto reference = [&](const Column &column) {
+		auto index = BindColumn(column, inputTables);
+		referenced[index.table][index.column] = true;
+	};
+	for (auto &selectColumn : info.selectColumns) {
+		reference(selectColumn);
+	}
+	for (auto &node : info.whereExtensionNodes) {
+		if (!node.column.columnName.empty()){
+			reference(node.column);
 		}
+	}
+	for (auto &orderByColumn : info.orderByColumns) {
+		reference(orderByColumn);
+	}
+	return referenced;
+}
 
-		// 最初のテーブルが最後の行を超えたなら出力行の生成は終わりです。
-		if (currentRows[0] == inputTables[0].data.end()) {
-			break;
+//! WHERE句の列指定のノードが、何個目の入力ファイルの何列目に相当するかを判別します。
+//! @param [in] inputTables ヘッダ行を読み取った入力データです。
+//! @return WHERE句の各ノードに対応する列の、入力ファイルとしてのインデックスです。列指定ではないノードでは使いません。
+//! @exception ResultValue 該当する列が無いか、複数ある場合はERR_BAD_COLUMN_NAMEです。
+vector<ColumnIndex> SqlQuery::BindWhereColumns(const vector<InputTable> &inputTables) const
+{
+	vector<ColumnIndex> whereColumnIndexes(queryInfo->whereExtensionNodes.size());
+	for (size_t i = 0; i < queryInfo->whereExtensionNodes.size(); ++i){
+		if (!queryInfo->whereExtensionNodes[i].column.columnName.empty()){
+			whereColumnIndexes[i] = BindColumn(queryInfo->whereExtensionNodes[i].column, inputTables);
 		}
 	}
+	return whereColumnIndexes;
+}
 
-	// ORDER句による並び替えの処理を行います。
-	if (!info.orderByColumns.empty()){
-		// ORDER句で指定されている列が、全ての入力行の中のどの行なのかを計算します。
-		vector<int> orderByColumnIndexes; // ORDER句で指定された列の、すべての行の中でのインデックスです。
-
-		for (auto &orderByColumn : info.orderByColumns) {
-			found = false;
-			for (size_t i = 0; i < allInputColumns.size(); ++i){
-				if (Equali(orderByColumn.columnName, allInputColumns[i].columnName) &&
-					(orderByColumn.tableName.empty() || // テーブル名が設定されている場合のみテーブル名の比較を行います。
-					//!*orderByTableNameCursol && !*allInputTableNameCursol)){
-					Equali(orderByColumn.tableName, allInputColumns[i].tableName))) {
-					// 既に見つかっているのにもう一つ見つかったらエラーです。
-					if (found){
-						throw ResultValue::ERR_BAD_COLUMN_NAME;
-					}
-					found = true;
-					orderByColumnIndexes.push_back(i);
+//! WHERE句の条件が、一つのテーブルの列だけを参照しているかどうかを調べます。
+//! @param [in] conjunct 調べる条件の、式木の根のノードのインデックスです。
+//! @param [in] whereColumnIndexes WHERE句の各ノードに対応する列の、入力ファイルとしてのインデックスです。
+//! @return 参照するテーブルが一つであれば、そのインデックスです。列を参照しないか、複数のテーブルを参照する場合は-1です。
+int SqlQuery::FindConjunctTable(const int conjunct, const vector<ColumnIndex> &whereColumnIndexes) const
+{
+	int table = -1; // 参照するテーブルです。
+	vector<int> nodes = { conjunct }; // 調べていないノードです。
+	while (!nodes.empty()){
+		auto index = nodes.back();
+		auto &node = queryInfo->whereExtensionNodes[index];
+		nodes.pop_back();
+		if (node.middleOperator.kind != TokenKind::NOT_TOKEN){
+			nodes.push_back(node.left);
+			nodes.push_back(node.right);
+		}
+		else if (!node.column.columnName.empty()){
+			if (0 <= table && table != whereColumnIndexes[index].table){
+				return -1;
+			}
+			table = whereColumnIndexes[index].table;
+		}
+	}
+	return table;
+}
+
+//! CSVファイルに出力データを書き込みます。
+//! ReadCsvが先頭のテーブルの値を残した場合は、データ行を少しずつ読み込み、読み込んだ行を含む行の組み合わせを書き込んでから次を読み込みます。
+//! 読み込んだ値の領域は再利用し、読み終えたページはメモリから外すので、先頭のテーブルの大きさによらない量のメモリで出力します。
+//! @param [in] outputFileName 出力するファイルの名前です。
+//! @param [in] inputTables ファイルから読み取ったデータです。先頭のテーブルの値を残した場合は、その値を読み込むごとに置き換えます。
+//! @param [in] parameters WHERE句のパラメータに設定する値です。
+//! @param [in] arena 実行中に使う領域を切り出すArenaです。
+void SqlQuery::WriteCsv(const string outputFileName, vector<InputTable> &inputTables, const vector<Data> &parameters, Arena &arena) const
+{
+	auto &info = *queryInfo; // 構文情報です。他の実行と共有しているので変更しません。
+	vector<Column> allInputColumns; // 入力に含まれるすべての列の一覧です。
+	int tableCount = info.tableNames.size(); // 入力するテーブルの数です。
+	ArenaVector<int> outputRows(arena); // WHEREの条件に合った行の組み合わせです。出力する一行ごとに、各テーブルの行をtableCount個ずつ並べます。
+	ofstream outputFile; // 書き込むファイルのファイルポインタです。
+
+	// 入力ファイルに書いてあったすべての列をallInputColumnsに設定します。
+	for (size_t i = 0; i < info.tableNames.size(); ++i){
+		transform(inputTables[i].columns.begin(), inputTables[i].columns.end(), back_inserter(allInputColumns),
+			[&](const Column& column) { return Column(info.tableNames[i], column.columnName); });
+	}
+
+	// SELECT句の列名指定が*だった場合は、入力CSVの列名がすべて選択されます。
+	auto &selectColumns = info.selectColumns.empty() ? allInputColumns : info.selectColumns; // 出力する列です。
+
+	vector<Column> outputColumns;
+
+	// SELECT句、WHERE句、ORDER句で指定された列名が、何個目の入力ファイルの何列目に相当するかを、行を読む前に一度だけ判別します。
+	vector<ColumnIndex> selectColumnIndexes; // SELECT句で指定された列の、入力ファイルとしてのインデックスです。
+	for (auto &selectColumn : selectColumns) {
+		selectColumnIndexes.push_back(BindColumn(selectColumn, inputTables));
+	}
+	auto whereColumnIndexes = BindWhereColumns(inputTables); // WHERE句の各ノードに対応する列の、入力ファイルとしてのインデックスです。列指定ではないノードでは使いません。
+	vector<ColumnIndex> orderByColumnIndexes; // ORDER句で指定された列の、入力ファイルとしてのインデックスです。
+	for (auto &orderByColumn : info.orderByColumns) {
+		orderByColumnIndexes.push_back(BindColumn(orderByColumn, inputTables));
+	}
+
+	// 出力する列名を設定します。
+	transform(selectColumnIndexes.begin(), selectColumnIndexes.end(), back_inserter(outputColumns),
+		[&](const ColumnIndex& index) {
+			return inputTables[index.table].columns[index.column];
+		});
+
+	int lastTable = tableCount - 1; // WHEREの条件をまとめて評価する最後のテーブルのインデックスです。
+	bool streamFirst = !inputTables[0].pendingRows.empty(); // 先頭のテーブルを、出力しながら少しずつ読み込むかどうかです。
+
+	// 一つのテーブルの列だけを参照する条件はReadCsvで評価済みなので、残りの条件を、型を検査した命令列に変換します。
+	// キャッシュの値を参照するテーブルは絞り込まずに読み込んでいるので、そのテーブルの条件も行の組み合わせに対して評価します。
+	// 先頭のテーブルを少しずつ読み込む場合は、先頭のテーブルの条件は読み込むごとに評価し、条件に合う行だけを組み合わせます。
+	vector<int> residualConjuncts; // 行の組み合わせに対して評価する条件です。
+	vector<int> firstConjuncts; // 少しずつ読み込む先頭のテーブルの行に対して評価する条件です。
+	for (auto conjunct : WhereProgram::SplitConjuncts(info)) {
+		auto table = FindConjunctTable(conjunct, whereColumnIndexes); // 条件が参照するテーブルです。
+		if (table < 0 || inputTables[table].shared){
+			residualConjuncts.push_back(conjunct);
+		}
+		else if (streamFirst && table == 0){
+			firstConjuncts.push_back(conjunct);
+		}
+	}
+	// 型の誤りは出力ファイルを開く前に検出するため、先頭のテーブルの条件も、型だけを持つ列に対して先に変換して検査します。
+	// 読み込むごとの評価には、FilterTableが範囲ごとに変換した命令列を使います。
+	WhereProgram whereProgram(info, residualConjuncts, lastTable, whereColumnIndexes, inputTables, literals, parameters, arena);
+	WhereProgram firstConditions(info, firstConjuncts, 0, whereColumnIndexes, inputTables, literals, parameters, arena);
+
+	ArenaVector<int> selection(WhereProgram::batchSize, 0, arena); // WHEREの条件に合った行の、まとめて評価した最初の行からの位置です。
+
+	// 入力された各テーブルの行の組み合わせのうち、WHEREの条件に合うものをoutputRowsに追加します。
+	auto collectRows = [&]() {
+		vector<int> currentRows(tableCount); // 入力された各テーブルの、現在出力している行です。
+		int lastTableRowCount = inputTables[lastTable].rowCount; // 最後のテーブルの行の数です。
+
+		// 行の無いテーブルがあれば、行の組み合わせはありません。
+		bool finished = any_of(inputTables.begin(), inputTables.end(), [](const InputTable& table) { return table.rowCount == 0; }); // 全ての行の組み合わせを出力し終えたかどうかです。
+
+		// 出力する行の組み合わせを設定します。
+		while (!finished){
+			// 最後のテーブルの行を、他のテーブルの現在の行と組み合わせて、batchSize行ずつまとめてWHEREの条件で評価します。
+			for (int batch = 0; batch < lastTableRowCount; batch += WhereProgram::batchSize){
+				int count = min<int>(WhereProgram::batchSize, lastTableRowCount - batch); // まとめて評価する行の数です。
+				currentRows[lastTable] = batch;
+				int selected = whereProgram.Execute(currentRows, count, selection.data()); // 条件に合った行の数です。
+
+				// WHEREの条件に合う行の組み合わせだけを出力します。
+				for (int i = 0; i < selected; ++i){
+					outputRows.insert(outputRows.end(), currentRows.begin(), currentRows.end() - 1);
+					outputRows.push_back(batch + selection[i]);
 				}
 			}
-			// 一つも見つからなくてもエラーです。
-			if (!found){
-				throw ResultValue::ERR_BAD_COLUMN_NAME;
+
+			// 各テーブルの行のすべての組み合わせを出力します。
+			// 最後のテーブル以外のテーブルのカレント行を、後ろのテーブルから順にインクリメントし、最終行を超えたテーブルは先頭に戻します。
+			finished = true;
+			for (int i = lastTable - 1; 0 <= i && finished; --i){
+				++currentRows[i];
+				finished = currentRows[i] == inputTables[i].rowCount;
+				if (finished){
+					currentRows[i] = 0;
+				}
 			}
 		}
+	};
 
-		// outputDataとallColumnOutputDataのソートを一緒に行います。簡便のため凝ったソートは使わず、選択ソートを利用します。
-		for (size_t i = 0; i < outputData.size(); ++i){
+	if (!streamFirst){
+		collectRows();
+	}
+	int outputRowCount = outputRows.size() / tableCount; // 出力する行の数です。
+
+	// ORDER句による並び替えの処理を行います。
+	if (!info.orderByColumns.empty()){
+		// outputRowsの行の組み合わせを並び替えます。簡便のため凝ったソートは使わず、選択ソートを利用します。
+		for (int i = 0; i < outputRowCount; ++i){
 			int minIndex = i; // 現在までで最小の行のインデックスです。
-			for (size_t j = i + 1; j < outputData.size(); ++j){
+			for (int j = i + 1; j < outputRowCount; ++j){
 				bool jLessThanMin = false; // インデックスがjの値が、minIndexの値より小さいかどうかです。
 				for (size_t k = 0; k < orderByColumnIndexes.size(); ++k){
-					const Data &mData = allColumnOutputData[minIndex][orderByColumnIndexes[k]]; // インデックスがminIndexのデータです。
-					const Data &jData = allColumnOutputData[j][orderByColumnIndexes[k]]; // インデックスがjのデータです。
+					auto &index = orderByColumnIndexes[k];
+					auto &column = inputTables[index.table].Values(index.column); // 比較する列です。
+					int mRow = outputRows[minIndex * tableCount + index.table]; // インデックスがminIndexの、列のテーブルの行です。
+					int jRow = outputRows[j * tableCount + index.table]; // インデックスがjの、列のテーブルの行です。
 					int cmp = 0; // 比較結果です。等しければ0、インデックスjの行が大きければプラス、インデックスminIndexの行が大きければマイナスとなります。
-					switch (mData.type)
+					switch (column.type)
 					{
 					case DataType::INTEGER:
-						cmp = jData.integer() - mData.integer();
+						cmp = column.Integers()[jRow] - column.Integers()[mRow];
 						break;
 					case DataType::STRING:
-						cmp = strcmp(jData.string().c_str(), mData.string().c_str());
+						// 番号で持つ列は、番号の大小が値の大小と一致します。
+						cmp = column.pool ? column.Codes()[jRow] - column.Codes()[mRow] : column.String(jRow).compare(column.String(mRow));
 						break;
 					}
 
@@ -850,13 +1229,9 @@ void SqlQuery::WriteCsv(const string outputFileName, const vector<InputTable> &i
 					minIndex = j;
 				}
 			}
-			vector<Data> tmp = outputData[minIndex];
-			outputData[minIndex] = outputData[i];
-			outputData[i] = tmp;
-
-			tmp = allColumnOutputData[minIndex];
-			allColumnOutputData[minIndex] = allColumnOutputData[i];
-			allColumnOutputData[i] = tmp;
+			if (minIndex != i){
+				swap_ranges(outputRows.begin() + minIndex * tableCount, outputRows.begin() + (minIndex + 1) * tableCount, outputRows.begin() + i * tableCount);
+			}
 		}
 	}
 
@@ -867,9 +1242,9 @@ void SqlQuery::WriteCsv(const string outputFileName, const vector<InputTable> &i
 	}
 
 	// 出力ファイルに列名を出力します。
-	for (size_t i = 0; i < info.selectColumns.size(); ++i){
+	for (size_t i = 0; i < selectColumns.size(); ++i){
 		outputFile << outputColumns[i].columnName;
-		if (i < info.selectColumns.size() - 1){
+		if (i < selectColumns.size() - 1){
 			outputFile << ",";
 		}
 		else{
@@ -877,25 +1252,73 @@ void SqlQuery::WriteCsv(const string outputFileName, const vector<InputTable> &i
 		}
 	}
 
-	// 出力ファイルにデータを出力します。
-	for (auto& outputRow : outputData) {
-		size_t i = 0;
-		for (auto &column : outputRow) {
-			switch (column.type) {
-			case DataType::INTEGER:
-				outputFile << column.integer();
-				break;
-			case DataType::STRING:
-				outputFile << column.string();
-				break;
+	// outputRowsの行の組み合わせを、出力ファイルに出力します。
+	auto writeRows = [&]() {
+		for (auto outputRow = outputRows.begin(); outputRow != outputRows.end(); outputRow += tableCount) {
+			size_t i = 0;
+			for (auto &index : selectColumnIndexes) {
+				auto &column = inputTables[index.table].Values(index.column); // 出力する列です。
+				int row = outputRow[index.table]; // 出力する列のテーブルの行です。
+				switch (column.type) {
+				case DataType::INTEGER:
+					outputFile << column.Integers()[row];
+					break;
+				case DataType::STRING:
+					outputFile << column.String(row);
+					break;
+				}
+
+				if (i++ < selectColumns.size() - 1){
+					outputFile << ",";
+				}
+				else{
+					outputFile << "\n";
+				}
 			}
+		}
+	};
 
-			if (i++ < info.selectColumns.size() - 1){
-				outputFile << ",";
+	// 出力ファイルにデータを出力します。
+	if (!streamFirst){
+		writeRows();
+	}
+	else{
+		// 先頭のテーブルのデータ行を一度に読み込む大きさずつ読み込み、読み込んだ行を含む行の組み合わせを出力してから次を読み込みます。
+		auto &first = inputTables[0]; // 少しずつ読み込むテーブルです。
+		auto referenced = FindReferencedColumns(inputTables)[0]; // 先頭のテーブルの列ごとの、SQLで参照されるかどうかです。
+		vector<char> integerColumns; // 先頭のテーブルの列ごとの、整数型の列かどうかです。
+		for (auto &column : first.values) {
+			integerColumns.push_back(column.type == DataType::INTEGER);
+		}
+		auto rowsCursol = first.pendingRows.data(); // 読み込んでいないデータ行の先頭です。
+		auto rowsEnd = first.pendingRows.data() + first.pendingRows.size(); // データ行の終了位置です。
+
+		// 他に行の無いテーブルがあれば、行の組み合わせは無いので読み込みません。
+		if (any_of(inputTables.begin() + 1, inputTables.end(), [](const InputTable& table) { return table.rowCount == 0; })){
+			rowsCursol = rowsEnd;
+		}
+		Arena batchArena; // 読み込んだ値の領域です。読み込んだ行を出力し終えるごとに破棄して再利用します。
+		while (rowsCursol != rowsEnd){
+			auto batchEnd = FindBatchEnd(rowsCursol, rowsEnd); // 一度に読み込むデータ行の終了位置です。
+			if (firstConjuncts.empty()){
+				auto chunks = ParseChunks(rowsCursol, batchEnd, referenced); // 範囲ごとに読み込んだ結果です。
+				AssignChunks(first, chunks, batchArena, nullptr);
+				for (size_t j = 0; j < integerColumns.size(); ++j){
+					if (integerColumns[j]){
+						first.values[j].ConvertToInteger();
+					}
+				}
 			}
 			else{
-				outputFile << "\n";
+				FilterTable(inputTables, 0, rowsCursol, batchEnd, referenced, integerColumns, firstConjuncts, whereColumnIndexes, parameters, batchArena, nullptr);
 			}
+			collectRows();
+			writeRows();
+			outputRows.clear();
+			first.values.clear();
+			batchArena.Reset();
+			first.file.Discard(rowsCursol, batchEnd);
+			rowsCursol = batchEnd;
 		}
 	}
 	if (outputFile.bad()){
@@ -915,8 +1338,38 @@ void SqlQuery::WriteCsv(const string outputFileName, const vector<InputTable> &i
 
 //! カレントディレクトリにあるCSVに対し、簡易的なSQLを実行し、結果をファイルに出力します。
 //! @param[in] outputFileName SQLの実行結果をCSVとして出力するファイル名です。拡張子を含みます。
-void SqlQuery::Execute(const string outputFileName)
+//! @param[in] parameters WHERE句のパラメータに設定する値です。パラメータのインデックスの順に並べます。
+void SqlQuery::Execute(const string outputFileName, const vector<Data> &parameters) const
+{
+	// 全てのパラメータに値が指定されていなければ、入力ファイルを読む前にエラーとします。
+	if (parameters.size() < queryInfo->parameterNames.size()){
+		throw ResultValue::ERR_BAD_PARAMETER;
+	}
+	// 実行中に使う領域は全てarenaから切り出し、実行の終わりにまとめて解放します。
+	Arena arena;
+	StringPool pool(arena); // 全てのテーブルの文字列の値で共有するプールです。異なるテーブルの値も番号で比較できます。
+	// ORDER句が無ければ全ての行を並べる必要が無いので、先頭のテーブルは出力しながら少しずつ読み込めます。
+	auto inputTables = ReadCsv(parameters, queryInfo->orderByColumns.empty(), arena, &pool);
+	WriteCsv(outputFileName, *inputTables, parameters, arena);
+}
+
+//! WHERE句に書かれたパラメータの名前を取得します。
+//! @return パラメータのインデックスの順に並んだ名前です。?で書かれたパラメータの名前は空文字列となります。
+const vector<string>& SqlQuery::GetParameterNames() const
+{
+	return queryInfo->parameterNames;
+}
+
+//! ORDER句の無いクエリで、先頭のテーブルを出力しながら少しずつ読み込む、データ行の最小のバイト数を設定します。プロセスで共有する設定です。
+//! @param [in] bytes 最小のバイト数です。0の場合は、ORDER句の無い全てのクエリで先頭のテーブルを少しずつ読み込みます。
+void SqlQuery::SetMinStreamBytes(const size_t bytes)
+{
+	minStreamBytes = bytes;
+}
+
+//! ORDER句の無いクエリで、先頭のテーブルを出力しながら少しずつ読み込む、データ行の最小のバイト数を取得します。
+//! @return 最小のバイト数です。
+size_t SqlQuery::MinStreamBytes()
 {
-	auto inputTables = ReadCsv();
-	WriteCsv(outputFileName, *inputTables);
+	return minStreamBytes;
 }
@@ -1,9 +1,16 @@
+#pragma once
+
 #include "token.hpp"
 #include "data.hpp"
 #include "operator.hpp"
 #include "sqlQueryInfo.hpp"
 #include "inputTable.hpp"
-#include "tokenReader.hpp"
+#include "columnarFile.hpp"
+#include "tableCache.hpp"
+#include "csvChunk.hpp"
+#include "whereProgram.hpp"
+#include "arena.hpp"
+#include "column_index.hpp"
 
 #include <string>
 #include <fstream>
@@ -14,36 +21,201 @@
 #include <cstring>
 
 //! ファイルに対して実行するSQLを表すクラスです。
+//! 実行中の状態は実行ごとに持ち、解析済みの構文情報は変更しないので、一つのインスタンスを複数のスレッドから同時に実行できます。
 class SqlQuery {
-	const std::string signNum = "+-0123456789"; //!< 全ての符号と数字です。
-	const std::string space = " \t\r\n"; //!< 全ての空白文字です。
-	
-	const std::vector<std::shared_ptr<const TokenReader>> tokenReaders; //!< トークンの読み込みロジックの集合です。
-	// signConditionsは先頭から順に検索されるので、前方一致となる二つの項目は順番に気をつけて登録しなくてはいけません。
-	const std::vector<Token> signConditions;    //!< 記号をトークンとして認識するための記号一覧情報です。
+	static constexpr size_t minChunkBytes = 1 << 20; //!< 入力CSVのデータ行を区切って並列に読み込む、一つの範囲の最小のバイト数です。
+
 	const std::vector<Operator> operators;      //!< 演算子の情報です。
-    std::shared_ptr<const SqlQueryInfo> queryInfo; //!< SQLに記述された内容です。
+    std::shared_ptr<const SqlQueryInfo> queryInfo; //!< SQLに記述された内容です。リテラルの値だけが異なるSQLの間で共有されます。
+	std::vector<Data> literals;                 //!< SQLに書かれたリテラルの値です。書かれた順に並びます。
+	std::shared_ptr<StringBuffer> literalStrings; //!< literalsの長い文字列の実体です。コピーしたインスタンスの間で共有されます。
 
-    bool Equali(const std::string str1, const std::string str2);
+	//! 二つの文字列を、大文字小文字を区別せずに比較し、等しいかどうかです。
+	//! @param [in] str1 比較される一つ目の文字列です。
+	//! @param [in] str2 比較される二つ目の文字列です。
+	//! @return 比較した結果、等しいかどうかです。
+	bool Equali(const std::string &str1, const std::string &str2) const;
 	//! @param [in] sql トークンに分解する元となるSQLです。
-	//! @return 切り出されたトークンです。
-	const std::shared_ptr<std::vector<Token>> GetTokens(const std::string sql) const;
+	//! @return 切り出されたトークンです。トークンはsqlを参照するので、sqlより長く使うことはできません。
+	const std::shared_ptr<std::vector<Token>> GetTokens(const std::string &sql) const;
+	//! 構文情報のキャッシュのキーとなる、正規化したSQLを作成します。リテラルはキーに含めず、値を取り出します。
+	//! @param [in] tokens 正規化の対象となるトークンです。末尾に番兵を含みます。
+	//! @param [out] literalValues 取り出したリテラルの値を、書かれた順に設定します。
+	//! @param [out] strings literalValuesの長い文字列の実体を格納する領域です。
+	//! @return 正規化したSQLです。
+	std::string Normalize(const std::vector<Token> &tokens, std::vector<Data> &literalValues, StringBuffer &strings) const;
     //! @param [in] tokens 解析の対象となるトークンです。
     //! @return 解析した結果の情報です。
     const std::shared_ptr<const SqlQueryInfo> AnalyzeTokens(const std::vector<Token> &tokens) const;
+	//! WHERE句の式を読み込みます。演算子とカッコの開始をスタックに積みながら、各トークンを一度だけ読んで木を構築します。
+	//! 再帰せずに読み込むので、カッコや演算子がどれだけ深く入れ子になっていても、呼び出しのスタックは溢れません。
+	//! @param [in] tokenCursol 読み込み開始位置です。読み込んだ式の次の位置に進めます。
+	//! @param [in] queryInfo 読み込んだノードを追加する先です。
+	//! @return 読み込んだ式の根となるノードの、whereExtensionNodesでのインデックスです。
+	//! @exception ResultValue カッコが閉じられていない場合はERR_SQL_SYNTAXです。
+	int ReadWhereExpression(std::vector<Token>::const_iterator &tokenCursol, SqlQueryInfo &queryInfo) const;
+	//! WHERE句のオペランドを読み込みます。カッコはReadWhereExpressionが読み込みます。
+	//! @param [in] tokenCursol 読み込み開始位置です。読み込んだオペランドの次の位置に進めます。
+	//! @param [in] queryInfo 読み込んだノードを追加する先です。
+	//! @return 読み込んだオペランドのノードの、whereExtensionNodesでのインデックスです。
+	int ReadWhereOperand(std::vector<Token>::const_iterator &tokenCursol, SqlQueryInfo &queryInfo) const;
     //! CSVファイルから入力データを読み取ります。
-    //! @param [in] queryInfo SQLの情報です。
-	//! @return ファイルから読み取ったデータです。
-    const std::shared_ptr<const std::vector<InputTable>> ReadCsv() const;
+	//! 全てのファイルのヘッダ行を読んでから、SELECT句、WHERE句、ORDER句で参照される列だけの値を読み込みます。参照されない列の値は読み飛ばし、行の数だけを数えます。
+	//! WHERE句の最上位のANDで区切った条件のうち、一つのテーブルの列だけを参照する条件は、そのテーブルを読む際に評価し、条件に合う行だけを読み込みます。
+	//! streamFirstがtrueで、先頭のテーブルのデータ行がMinStreamBytes以上の場合は、全ての値から列の型だけを求め、値はWriteCsvで出力しながら少しずつ読み込みます。
+	//! ColumnarFileが有効な場合は、各テーブルをサイドカーファイルから読み込みます。サイドカーファイルが無いか古い場合は、CSVファイルから作成してから読み込みます。
+	//! TableCacheの上限が0でない場合は、キャッシュにあるテーブルは値を読まずにキャッシュの値を参照し、上限に収まる大きさのテーブルはキャッシュに追加してから参照します。
+	//! @param [in] parameters WHERE句のパラメータに設定する値です。
+	//! @param [in] streamFirst 先頭のテーブルの値を読み込まずに残してよいかどうかです。
+	//! @param [in] arena 読み取ったデータの領域を切り出すArenaです。
+	//! @param [in] pool 文字列の値に番号を振るプールです。nullptrの場合は番号を振りません。
+	//! @return ファイルから読み取ったデータです。参照されない列のvaluesは空です。先頭のテーブルの値を残した場合は、そのvaluesは値を持たずに型だけを持ち、pendingRowsが残したデータ行を参照します。
+	//! キャッシュの値を参照するテーブルは、valuesを持たずにsharedを設定し、WHERE句の条件で絞り込みません。
+	//! @exception ResultValue 参照する列が無いか、複数ある場合はERR_BAD_COLUMN_NAMEです。評価した条件の型が適切ではない場合はERR_WHERE_OPERAND_TYPEです。
+    const std::shared_ptr<std::vector<InputTable>> ReadCsv(const std::vector<Data> &parameters, const bool streamFirst, Arena &arena, StringPool *pool) const;
+	//! 入力CSVのデータ行を区切る範囲の数を求めます。範囲の数は、同時に実行できるスレッドの数を上限とし、範囲がminChunkBytesより小さくならない数です。
+	//! @param [in] bytes データ行のバイト数です。
+	//! @return 区切る範囲の数です。
+	static int ChunkCount(const size_t bytes);
+	//! 入力CSVのデータ行を、改行文字の直後で区切った範囲ごとに別のスレッドで読み込みます。
+	//! @param [in] begin データ行の先頭です。
+	//! @param [in] end データ行の終了位置です。
+	//! @param [in] referenced ヘッダ行の列ごとの、値を読み込むかどうかです。
+	//! @return 範囲ごとに読み込んだ結果です。ファイルでの順に並びます。
+	static std::vector<CsvChunk> ParseChunks(const char *begin, const char *end, const std::vector<char> &referenced);
+	//! 出力しながら少しずつ読み込むテーブルの、一度に読み込むデータ行の終了位置を求めます。
+	//! 一度に読み込む大きさは、並列に読み込む範囲の数の上限だけminChunkBytesを並べた大きさを目安とし、改行文字の直後で区切ります。
+	//! @param [in] begin 読み込むデータ行の先頭です。
+	//! @param [in] end データ行の終了位置です。
+	//! @return 一度に読み込むデータ行の終了位置です。
+	static const char* FindBatchEnd(const char *begin, const char *end);
+	//! 入力CSVのデータ行の、全ての値が整数となる列を求めます。
+	//! 値は列に持たずに、一度に読み込む大きさずつ、区切った範囲ごとに別のスレッドで調べます。fileを指定した場合は読み終えたページをメモリから外すので、ファイルの大きさによらない量のメモリで調べます。
+	//! 整数ではない値が見つかった列は、以降は調べません。
+	//! @param [in] file データ行を含む、マッピングした入力ファイルです。nullptrの場合は、ページを外さずに一度に全てのデータ行を調べます。
+	//! @param [in] begin データ行の先頭です。
+	//! @param [in] end データ行の終了位置です。
+	//! @param [in] referenced ヘッダ行の列ごとの、SQLで参照されるかどうかです。
+	//! @return 列ごとの、全ての値が整数かどうかです。参照されない列はfalseです。
+	static std::vector<char> InferIntegerColumns(const MappedFile *file, const char *begin, const char *end, const std::vector<char> &referenced);
+	//! 値を持たずに型だけを決めた列を、テーブルの全ての列として設定します。文字列型の列は番号で持ちません。
+	//! WHERE句の条件を、値を読み込む前に命令列に変換するために使います。
+	//! @param [in, out] table 列を設定するテーブルです。
+	//! @param [in] integerColumns 列ごとの、整数型とするかどうかです。
+	//! @param [in] arena 列の値の配列の領域を切り出すArenaです。
+	static void AddTypedColumns(InputTable &table, const std::vector<char> &integerColumns, Arena &arena);
+	//! 範囲ごとに読み込んだデータ行を、ファイルでの順につなげてテーブルの値とします。列の型は変換しません。
+	//! @param [in, out] table 値と行の数を設定するテーブルです。
+	//! @param [in] chunks 範囲ごとに読み込んだ結果です。値は移動します。
+	//! @param [in] arena 列の値の配列の領域を切り出すArenaです。
+	//! @param [in] pool 文字列の値に番号を振るプールです。nullptrの場合は番号を振りません。
+	static void AssignChunks(InputTable &table, std::vector<CsvChunk> &chunks, Arena &arena, StringPool *pool);
+	//! テーブルの全ての列と全ての行の値を、クエリの実行によらないCachedTableに読み込み、TableCacheに追加します。
+	//! 文字列の値はCachedTableのプールで番号を振り、番号で持たない値はCachedTableのArenaに複写するので、入力ファイルのマッピングを参照しません。
+	//! Arenaが上限を超えてTableCacheに追加されなかった場合も、読み込んだテーブルを返します。以降のクエリはTableCache::IsRejectedで判断し、このテーブルを読み込み直しません。
+	//! @param [in] table ヘッダ行を読み取り、入力ファイルをマッピングしたテーブルです。
+	//! @param [in] dataStart データ行の先頭です。
+	//! @param [in] key 入力ファイルの正規化したパスです。
+	//! @return 読み込んだテーブルです。使い終わるまでCachedTableを解放しません。
+	static std::shared_ptr<const InputTable> CacheTable(const InputTable &table, const char *dataStart, const std::string &key);
+	//! テーブルのデータ行を、範囲ごとに別のスレッドで読みながら、テーブルの列だけを参照するWHERE句の条件でbatchSize行ずつ絞り込み、条件に合う行だけをテーブルの値とします。
+	//! 範囲ごとに、まとめて評価する行の値を持つ列と命令列を用意し、読んだ行がbatchSize行になるごとに評価します。条件に合わない行の値は、StringPoolに加えず、列にも持ちません。
+	//! 先頭の範囲はarenaとpoolを使って条件に合う行の値をそのまま列に追加し、他の範囲の条件に合う行の値は、読み終えてからファイルでの順につなげます。
+	//! @param [in, out] inputTables 入力データです。tableIndexのテーブルの値と行の数を設定します。
+	//! @param [in] tableIndex 絞り込むテーブルのインデックスです。
+	//! @param [in] begin データ行の先頭です。
+	//! @param [in] end データ行の終了位置です。
+	//! @param [in] referenced 列ごとの、SQLで参照されるかどうかです。
+	//! @param [in] integerColumns 列ごとの、整数型の列とするかどうかです。テーブルの全ての行の値が整数である列です。
+	//! @param [in] conjuncts 評価する条件の、式木の根のノードのインデックスです。
+	//! @param [in] whereColumnIndexes WHERE句の各ノードに対応する列の、入力ファイルとしてのインデックスです。
+	//! @param [in] parameters WHERE句のパラメータに設定する値です。
+	//! @param [in] arena 読み取ったデータの領域を切り出すArenaです。
+	//! @param [in] pool 文字列の値に番号を振るプールです。nullptrの場合は番号を振りません。
+	//! @exception ResultValue 条件の型が適切ではない場合はERR_WHERE_OPERAND_TYPEです。
+	void FilterTable(std::vector<InputTable> &inputTables, const int tableIndex, const char *begin, const char *end, const std::vector<char> &referenced, const std::vector<char> &integerColumns,
+		const std::vector<int> &conjuncts, const std::vector<ColumnIndex> &whereColumnIndexes, const std::vector<Data> &parameters, Arena &arena, StringPool *pool) const;
+	//! 範囲のデータ行を読みながら、batchSize行ずつまとめて条件で評価し、条件に合う行の値だけを列に追加します。
+	//! まとめた行の値は評価し終えるごとに捨て、その領域を次の行に再利用するので、条件に合わない行の値は持ち続けません。
+	//! @param [in] begin 範囲の先頭です。行の先頭である必要があります。
+	//! @param [in] end 範囲の終了位置です。ファイルの末尾でなければ改行文字の直後である必要があります。
+	//! @param [in] referenced 列ごとの、値を読み込むかどうかです。
+	//! @param [in, out] batchTables tableIndexのテーブルに、まとめて評価する行の値を持つ、型を決めた列を持つ入力データです。
+	//! @param [in] tableIndex 絞り込むテーブルのインデックスです。
+	//! @param [in] conditions batchTablesのtableIndexのテーブルの行をまとめて評価する命令列です。
+	//! @param [in] arena 評価に使う領域を切り出すArenaです。
+	//! @param [in, out] selected 条件に合った行の値を追加する列です。
+	//! @return 条件に合った行の数です。
+	static int FilterChunk(const char *begin, const char *end, const std::vector<char> &referenced, std::vector<InputTable> &batchTables, const int tableIndex,
+		WhereProgram &conditions, Arena &arena, std::vector<ColumnValues> &selected);
+	//! 一つのテーブルの行を、そのテーブルの列だけを参照する条件でbatchSize行ずつまとめて評価し、条件に合う行を求めます。
+	//! @param [in] tableCount 入力するテーブルの数です。
+	//! @param [in] tableIndex 評価するテーブルのインデックスです。
+	//! @param [in] rowCount 評価するテーブルの行の数です。
+	//! @param [in] conditions tableIndexのテーブルの行をまとめて評価する命令列です。
+	//! @param [in] arena 評価に使う領域を切り出すArenaです。
+	//! @return 条件に合った行です。昇順に並びます。
+	static std::vector<int> SelectRows(const size_t tableCount, const int tableIndex, const int rowCount, WhereProgram &conditions, Arena &arena);
+	//! サイドカーファイルからテーブルの値を読み込み、テーブルの列だけを参照するWHERE句の条件で絞り込みます。
+	//! 列の型はサイドカーファイルに記録された、全ての行の値から判断した型です。値はサイドカーファイルをマッピングした領域を参照し、文字列に番号を振り直しません。
+	//! @param [in, out] inputTables 入力データです。tableIndexのテーブルの値と行の数を設定し、fileをサイドカーファイルのマッピングに置き換えます。
+	//! @param [in] tableIndex 読み込むテーブルのインデックスです。
+	//! @param [in] columnar テーブルのCSVファイルに対応する、開いたサイドカーファイルです。
+	//! @param [in] referenced 列ごとの、SQLで参照されるかどうかです。
+	//! @param [in] conjuncts 評価する条件の、式木の根のノードのインデックスです。空の場合は全ての行を読み込みます。
+	//! @param [in] whereColumnIndexes WHERE句の各ノードに対応する列の、入力ファイルとしてのインデックスです。
+	//! @param [in] parameters WHERE句のパラメータに設定する値です。
+	//! @param [in] arena 読み取ったデータの領域を切り出すArenaです。
+	//! @exception ResultValue 条件の型が適切ではない場合はERR_WHERE_OPERAND_TYPEです。
+	void LoadColumnar(std::vector<InputTable> &inputTables, const int tableIndex, ColumnarFile &columnar, const std::vector<char> &referenced,
+		const std::vector<int> &conjuncts, const std::vector<ColumnIndex> &whereColumnIndexes, const std::vector<Data> &parameters, Arena &arena) const;
+	//! 列の指定が、何個目の入力ファイルの何列目に相当するかを判別します。
+	//! @param [in] column 判別する列の指定です。
+	//! @param [in] inputTables ファイルから読み取ったデータです。
+	//! @return 列の入力ファイルとしてのインデックスです。
+	//! @exception ResultValue 該当する列が無いか、複数ある場合はERR_BAD_COLUMN_NAMEです。
+	ColumnIndex BindColumn(const Column &column, const std::vector<InputTable> &inputTables) const;
+	//! SELECT句、WHERE句、ORDER句で参照される列を判別します。SELECT句の列名指定が*の場合は、全ての列が参照されます。
+	//! @param [in] inputTables ヘッダ行を読み取った入力データです。
+	//! @return テーブルごと、列ごとの、参照されるかどうかです。
+	//! @exception ResultValue 参照する列が無いか、複数ある場合はERR_BAD_COLUMN_NAMEです。
+	std::vector<std::vector<char>> FindReferencedColumns(const std::vector<InputTable> &inputTables) const;
+	//! WHERE句の列指定のノードが、何個目の入力ファイルの何列目に相当するかを判別します。
+	//! @param [in] inputTables ヘッダ行を読み取った入力データです。
+	//! @return WHERE句の各ノードに対応する列の、入力ファイルとしてのインデックスです。列指定ではないノードでは使いません。
+	//! @exception ResultValue 該当する列が無いか、複数ある場合はERR_BAD_COLUMN_NAMEです。
+	std::vector<ColumnIndex> BindWhereColumns(const std::vector<InputTable> &inputTables) const;
+	//! WHERE句の条件が、一つのテーブルの列だけを参照しているかどうかを調べます。
+	//! @param [in] conjunct 調べる条件の、式木の根のノードのインデックスです。
+	//! @param [in] whereColumnIndexes WHERE句の各ノードに対応する列の、入力ファイルとしてのインデックスです。
+	//! @return 参照するテーブルが一つであれば、そのインデックスです。列を参照しないか、複数のテーブルを参照する場合は-1です。
+	int FindConjunctTable(const int conjunct, const std::vector<ColumnIndex> &whereColumnIndexes) const;
     //! CSVファイルに出力データを書き込みます。
-    //! @param [in] queryInfo SQLの情報です。
-	//! @param [in] inputData ファイルから読み取ったデータです。
-	void WriteCsv(const std::string outputFileName, const std::vector<InputTable> &inputTables) const;
+	//! ReadCsvが先頭のテーブルの値を残した場合は、データ行を少しずつ読み込み、読み込んだ行を含む行の組み合わせを書き込んでから次を読み込みます。
+	//! 読み込んだ値の領域は再利用し、読み終えたページはメモリから外すので、先頭のテーブルの大きさによらない量のメモリで出力します。
+	//! @param [in] outputFileName 出力するファイルの名前です。
+	//! @param [in] inputTables ファイルから読み取ったデータです。先頭のテーブルの値を残した場合は、その値を読み込むごとに置き換えます。
+	//! @param [in] parameters WHERE句のパラメータに設定する値です。
+	//! @param [in] arena 実行中に使う領域を切り出すArenaです。
+	void WriteCsv(const std::string outputFileName, std::vector<InputTable> &inputTables, const std::vector<Data> &parameters, Arena &arena) const;
 public:
+	static constexpr size_t defaultMinStreamBytes = 64 << 20; //!< MinStreamBytesの初期値です。これより小さなテーブルは、型を求めるために値を二度読むより、一度に読み込む方が速く読めます。
+
 	//! SqlQueryクラスの新しいインスタンスを初期化します。
+	//! リテラルの値を除いて同じSQLが解析済みであれば、その構文情報を使い、構文解析を行いません。
     //! @param [in] sql 実行するSQLです。
 	SqlQuery(const std::string sql);
 	//! カレントディレクトリにあるCSVに対し、簡易的なSQLを実行し、結果をファイルに出力します。
 	//! @param[in] outputFileName SQLの実行結果をCSVとして出力するファイル名です。拡張子を含みます。
-	void Execute(const std::string outputFileName);
+	//! @param[in] parameters WHERE句のパラメータに設定する値です。パラメータのインデックスの順に並べます。
+	void Execute(const std::string outputFileName, const std::vector<Data> &parameters = std::vector<Data>()) const;
+	//! WHERE句に書かれたパラメータの名前を取得します。
+	//! @return パラメータのインデックスの順に並んだ名前です。?で書かれたパラメータの名前は空文字列となります。
+	const std::vector<std::string>& GetParameterNames() const;
+	//! ORDER句の無いクエリで、先頭のテーブルを出力しながら少しずつ読み込む、データ行の最小のバイト数を設定します。プロセスで共有する設定です。
+	//! @param [in] bytes 最小のバイト数です。0の場合は、ORDER句の無い全てのクエリで先頭のテーブルを少しずつ読み込みます。
+	static void SetMinStreamBytes(const size_t bytes);
+	//! ORDER句の無いクエリで、先頭のテーブルを出力しながら少しずつ読み込む、データ行の最小のバイト数を取得します。
+	//! @return 最小のバイト数です。
+	static size_t MinStreamBytes();
 };
\ No newline at end of file
@@ -1,21 +1,24 @@
-#pragma once
-
-#include "column.hpp"
-#include "token_kind.hpp"
-#include "extension_tree_node.hpp"
-
-#include <vector>
-#include <string>
-#include <memory>
-
-//! SqlQueryの構文情報を扱うクラスです。
-class SqlQueryInfo
-{
-public:
-	std::vector<std::string> tableNames; //!< FROM句で指定しているテーブル名です。
-	std::vector<Column> selectColumns; //!< SELECT句に指定された列名です。
-	std::vector<Column> orderByColumns; //!< ORDER句に指定された列名です。
-	std::vector<TokenKind> orders; //!< 同じインデックスのorderByColumnsに対応している、昇順、降順の指定です。
-	std::vector<std::shared_ptr<ExtensionTreeNode>> whereExtensionNodes; //!< WHEREに指定された木のノードを、木構造とは無関係に格納します。
-	std::shared_ptr<ExtensionTreeNode> whereTopNode; //!< 式木の根となるノードです。
+#pragma once
+
+#include "column.hpp"
+#include "token_kind.hpp"
+#include "extension_tree_node.hpp"
+
+#include <vector>
+#include <string>
+#include <memory>
+
+//! SqlQueryの構文情報を扱うクラスです。
+//! 構文解析の後は変更せず、同じ形のSQLの全ての実行で共有します。
+class SqlQueryInfo
+{
+public:
+	std::vector<std::string> tableNames; //!< FROM句で指定しているテーブル名です。
+	std::vector<Column> selectColumns; //!< SELECT句に指定された列名です。
+	std::vector<Column> orderByColumns; //!< ORDER句に指定された列名です。
+	std::vector<TokenKind> orders; //!< 同じインデックスのorderByColumnsに対応している、昇順、降順の指定です。
+	std::vector<ExtensionTreeNode> whereExtensionNodes; //!< WHEREに指定された木のノードを、木構造とは無関係に格納します。ノード同士はこの配列のインデックスでつながります。
+	int whereTopNode = -1; //!< 式木の根となるノードのwhereExtensionNodesでのインデックスです。WHERE句がない場合は-1となります。
+	int literalCount = 0; //!< WHERE句に書かれたリテラルの数です。リテラルの値は構文情報に含めず、SQLごとに持ちます。
+	std::vector<std::string> parameterNames; //!< WHERE句に書かれたパラメータの名前です。インデックスがパラメータのインデックスとなり、?で書かれたパラメータの名前は空文字列となります。
 };
\ No newline at end of file
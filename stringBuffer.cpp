@@ -0,0 +1,28 @@
+#include "stringBuffer.hpp"
+
+#include <cstring>
+
+using namespace std;
+
+//! 文字列をコピーして格納します。
+//! @param [in] value 格納する文字列です。
+//! @return 格納した文字列です。StringBufferが破棄されるまで使えます。
+string_view StringBuffer::Store(const string_view value)
+{
+	// 塊より大きな文字列は、その文字列だけの領域を確保します。
+	if (chunkSize < value.size()){
+		larges.push_back(unique_ptr<char[]>(new char[value.size()]));
+		memcpy(larges.back().get(), value.data(), value.size());
+		return string_view(larges.back().get(), value.size());
+	}
+
+	// 最後の塊に入りきらなければ、新しい塊を確保します。
+	if (chunkSize - used < value.size()){
+		chunks.push_back(unique_ptr<char[]>(new char[chunkSize]));
+		used = 0;
+	}
+	auto stored = chunks.back().get() + used;
+	memcpy(stored, value.data(), value.size());
+	used += value.size();
+	return string_view(stored, value.size());
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+//! Dataにインラインで格納できない長い文字列の実体を保持する領域です。
+//! 文字列は大きな塊にまとめて追記し、一度格納した文字列の位置は、StringBufferがムーブされても破棄されるまで変わりません。
+class StringBuffer
+{
+	static const size_t chunkSize = 64 * 1024;    //!< 一度に確保する領域の大きさです。
+
+	std::vector<std::unique_ptr<char[]>> chunks;  //!< 確保した領域です。
+	std::vector<std::unique_ptr<char[]>> larges;  //!< 一つの塊に入りきらない文字列のために、個別に確保した領域です。
+	size_t used = chunkSize;                      //!< 最後に確保した領域の使用済みのバイト数です。
+
+public:
+	//! StringBufferクラスの新しいインスタンスを初期化します。
+	StringBuffer() = default;
+
+	StringBuffer(const StringBuffer&) = delete;
+	StringBuffer& operator=(const StringBuffer&) = delete;
+	StringBuffer(StringBuffer&&) = default;
+	StringBuffer& operator=(StringBuffer&&) = default;
+
+	//! 文字列をコピーして格納します。
+	//! @param [in] value 格納する文字列です。
+	//! @return 格納した文字列です。StringBufferが破棄されるまで使えます。
+	std::string_view Store(const std::string_view value);
+};
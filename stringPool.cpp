@@ -0,0 +1,96 @@
+#include "stringPool.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+using namespace std;
+
+//! StringPoolクラスの新しいインスタンスを初期化します。
+//! @param [in] arena 文字列の実体と表の領域を切り出すArenaです。
+StringPool::StringPool(Arena &arena) :
+	arena(arena),
+	values(arena),
+	index(0, hash<string_view>(), equal_to<string_view>(), arena)
+{
+}
+
+//! 文字列の番号を取得します。初めての文字列であれば、実体をコピーして新しい番号を振ります。
+//! @param [in] value 番号を取得する文字列です。
+//! @return 文字列の番号です。
+int StringPool::Intern(const string_view value)
+{
+	auto found = index.find(value);
+	if (found != index.end()){
+		return found->second;
+	}
+	auto stored = static_cast<char*>(arena.Allocate(value.size(), 1)); // プールが保持する文字列の実体です。
+	memcpy(stored, value.data(), value.size());
+	string_view storedValue(stored, value.size());
+	values.push_back(Data(storedValue));
+	index.emplace(storedValue, values.size() - 1);
+	return values.size() - 1;
+}
+
+//! 文字列の番号を検索します。
+//! @param [in] value 番号を検索する文字列です。
+//! @return 文字列の番号です。プールに無い場合は-1です。
+int StringPool::Find(const string_view value) const
+{
+	auto found = index.find(value);
+	return found == index.end() ? -1 : found->second;
+}
+
+//! 辞書順に並べた値を、実体を複写せずに順に追加します。Sortを呼ばずに、番号が値の辞書順となるプールを作ります。
+//! @param [in] value 追加する値です。それまでに追加した値より辞書順で後の値で、プールを使い終わるまで有効な領域を参照している必要があります。
+void StringPool::AppendSorted(const string_view value)
+{
+	values.push_back(Data(value));
+	index.emplace(value, values.size() - 1);
+}
+
+//! 番号を値の辞書順に振り直します。以降は値を追加できません。
+//! @return 元の番号をインデックスとした、振り直した番号です。
+vector<int> StringPool::Sort()
+{
+	vector<int> order(values.size()); // 辞書順に並べた元の番号です。
+	iota(order.begin(), order.end(), 0);
+	sort(order.begin(), order.end(), [&](const int a, const int b) { return values[a].string() < values[b].string(); });
+
+	vector<int> ranks(values.size()); // 元の番号ごとの、振り直した番号です。
+	ArenaVector<Data> sorted(arena); // 振り直した番号の順に並べた値です。
+	sorted.reserve(values.size());
+	for (size_t i = 0; i < order.size(); ++i) {
+		ranks[order[i]] = i;
+		sorted.push_back(values[order[i]]);
+	}
+	values.swap(sorted);
+	for (auto &entry : index) {
+		entry.second = ranks[entry.second];
+	}
+	return ranks;
+}
+
+//! Sortで振り直した番号で、値以上となる最初の番号を検索します。
+//! @param [in] value 検索する文字列です。
+//! @return 値以上となる最初の番号です。全ての値が小さい場合はSizeです。
+int StringPool::LowerBound(const string_view value) const
+{
+	return lower_bound(values.begin(), values.end(), value,
+		[](const Data &cell, const string_view target) { return cell.string() < target; }) - values.begin();
+}
+
+//! 番号の値を取得します。
+//! @param [in] id 値の番号です。
+//! @return 番号の値です。
+const Data& StringPool::Cell(const int id) const
+{
+	return values[id];
+}
+
+//! 保持している値の数を取得します。
+//! @return 保持している値の数です。
+int StringPool::Size() const
+{
+	return values.size();
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "arena.hpp"
+#include "data.hpp"
+
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//! 一回のクエリの実行で読み込んだ文字列を、同じ値ごとに一つだけ保持するプールです。
+//! 値には追加した順に0からの番号を振るので、同じプールの番号同士を比べれば、文字列を比べずに等しいかどうかがわかります。
+//! 全ての値を追加した後にSortを呼ぶと、番号を値の辞書順に振り直すので、番号同士の大小も文字列の大小と一致します。
+//! 文字列の実体と表の領域はArenaから切り出します。
+class StringPool
+{
+	//! 文字列から番号を引く表です。
+	typedef std::unordered_map<std::string_view, int, std::hash<std::string_view>, std::equal_to<std::string_view>,
+		ArenaAllocator<std::pair<const std::string_view, int>>> Index;
+
+	Arena &arena;             //!< 文字列の実体を切り出すArenaです。
+	ArenaVector<Data> values; //!< 番号の順に並べた値です。長い文字列はarenaの実体を参照します。
+	Index index;              //!< 文字列から番号を引く表です。
+
+public:
+	//! StringPoolクラスの新しいインスタンスを初期化します。
+	//! @param [in] arena 文字列の実体と表の領域を切り出すArenaです。
+	StringPool(Arena &arena);
+
+	StringPool(const StringPool&) = delete;
+	StringPool& operator=(const StringPool&) = delete;
+
+	//! 文字列の番号を取得します。初めての文字列であれば、実体をコピーして新しい番号を振ります。
+	//! @param [in] value 番号を取得する文字列です。
+	//! @return 文字列の番号です。
+	int Intern(const std::string_view value);
+
+	//! 文字列の番号を検索します。
+	//! @param [in] value 番号を検索する文字列です。
+	//! @return 文字列の番号です。プールに無い場合は-1です。
+	int Find(const std::string_view value) const;
+
+	//! 辞書順に並べた値を、実体を複写せずに順に追加します。Sortを呼ばずに、番号が値の辞書順となるプールを作ります。
+	//! @param [in] value 追加する値です。それまでに追加した値より辞書順で後の値で、プールを使い終わるまで有効な領域を参照している必要があります。
+	void AppendSorted(const std::string_view value);
+
+	//! 番号を値の辞書順に振り直します。以降は値を追加できません。
+	//! @return 元の番号をインデックスとした、振り直した番号です。
+	std::vector<int> Sort();
+
+	//! Sortで振り直した番号で、値以上となる最初の番号を検索します。
+	//! @param [in] value 検索する文字列です。
+	//! @return 値以上となる最初の番号です。全ての値が小さい場合はSizeです。
+	int LowerBound(const std::string_view value) const;
+
+	//! 番号の値を取得します。
+	//! @param [in] id 値の番号です。
+	//! @return 番号の値です。
+	const Data& Cell(const int id) const;
+
+	//! 保持している値の数を取得します。
+	//! @return 保持している値の数です。
+	int Size() const;
+};
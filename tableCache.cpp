@@ -0,0 +1,197 @@
+#include "tableCache.hpp"
+
+#include <climits>
+#include <cstdlib>
+#include <sys/stat.h>
+
+using namespace std;
+
+//! CachedTableクラスの新しいインスタンスを初期化します。
+CachedTable::CachedTable() : pool(arena)
+{
+}
+
+//! TableCacheクラスの新しいインスタンスを初期化します。
+//! @param [in] budget 保持するテーブルのArenaの大きさの合計の上限です。0の場合はテーブルを保持しません。
+TableCache::TableCache(const size_t budget) : budget(budget)
+{
+}
+
+//! プロセスで共有されるキャッシュを取得します。
+//! @return 初回の呼び出しで構築されたキャッシュです。
+TableCache& TableCache::Instance()
+{
+	static TableCache instance(defaultBudget);
+	return instance;
+}
+
+//! 入力ファイルのパスを、キャッシュのキーとなる正規化したパスに変換します。
+//! @param [in] path 入力ファイルのパスです。
+//! @return 正規化したパスです。ファイルが無い場合は空文字列です。
+string TableCache::Canonicalize(const string &path)
+{
+	char resolved[PATH_MAX]; // 正規化したパスです。
+	return realpath(path.c_str(), resolved) ? string(resolved) : string();
+}
+
+//! 入力ファイルを読み込んだテーブルを検索します。見つかったテーブルは最も最近使われたものとなります。
+//! 入力ファイルの大きさか最終更新時刻が、テーブルを読み込んだ時点と異なる場合は、テーブルを捨てて見つからなかったものとします。
+//! @param [in] key 入力ファイルの正規化したパスです。
+//! @return 見つかったテーブルです。見つからなかった場合はnullptrを返します。
+shared_ptr<const CachedTable> TableCache::Find(const string &key)
+{
+	struct stat status; // 入力ファイルの現在の情報です。
+	auto exists = stat(key.c_str(), &status) == 0; // 入力ファイルの情報を取得できたかどうかです。
+
+	lock_guard<mutex> lock(entriesMutex);
+	auto found = index.find(key);
+	if (found == index.end()){
+		++misses;
+		return nullptr;
+	}
+	auto &table = *found->second->second;
+	if (!exists || table.fileSize != static_cast<size_t>(status.st_size) ||
+		table.modified.tv_sec != status.st_mtim.tv_sec || table.modified.tv_nsec != status.st_mtim.tv_nsec){
+		Erase(found->second);
+		++misses;
+		return nullptr;
+	}
+	++hits;
+	entries.splice(entries.begin(), entries, found->second);
+	return found->second->second;
+}
+
+//! 入力ファイルを読み込んだテーブルを追加します。上限を超えた場合は最も長く使われていないテーブルから捨てます。
+//! テーブルだけで上限を超える場合は追加せず、入力ファイルを追加しなかったものとして覚えます。
+//! @param [in] key 入力ファイルの正規化したパスです。
+//! @param [in] table 追加するテーブルです。
+//! @return テーブルを追加した場合はtrueです。
+bool TableCache::Add(const string &key, const shared_ptr<const CachedTable> table)
+{
+	auto bytes = table->arena.Size(); // 追加するテーブルのArenaの大きさです。
+	lock_guard<mutex> lock(entriesMutex);
+	if (budget < bytes){
+		rejections[key] = { bytes, table->fileSize, table->modified };
+		return false;
+	}
+	rejections.erase(key);
+
+	// 他のスレッドが先に追加していた場合は、後から読み込んだテーブルに置き換えます。
+	auto found = index.find(key);
+	if (found != index.end()){
+		Erase(found->second);
+	}
+	entries.emplace_front(key, table);
+	index[key] = entries.begin();
+	usedBytes += bytes;
+	Shrink();
+	return true;
+}
+
+//! 入力ファイルが、テーブルだけで上限を超えたために追加しなかったものかどうかを調べます。
+//! 入力ファイルの大きさか最終更新時刻が追加しなかった時点と異なる場合は、覚えていた入力ファイルを忘れ、追加しなかったものではないとします。
+//! @param [in] key 入力ファイルの正規化したパスです。
+//! @param [in] fileSize 入力ファイルの現在の大きさです。
+//! @param [in] modified 入力ファイルの現在の最終更新時刻です。
+//! @return 追加しなかった入力ファイルであればtrueです。
+bool TableCache::IsRejected(const string &key, const size_t fileSize, const timespec &modified)
+{
+	lock_guard<mutex> lock(entriesMutex);
+	auto found = rejections.find(key);
+	if (found == rejections.end()){
+		return false;
+	}
+	auto &rejection = found->second;
+	if (rejection.fileSize != fileSize || rejection.modified.tv_sec != modified.tv_sec || rejection.modified.tv_nsec != modified.tv_nsec){
+		rejections.erase(found);
+		return false;
+	}
+	return true;
+}
+
+//! テーブルを捨てます。entriesMutexをロックしてから呼び出します。
+//! @param [in] entry 捨てるテーブルの、entriesの要素です。
+void TableCache::Erase(const Entries::iterator entry)
+{
+	usedBytes -= entry->second->arena.Size();
+	index.erase(entry->first);
+	entries.erase(entry);
+}
+
+//! 上限を超えなくなるまで、最も長く使われていないテーブルから捨てます。entriesMutexをロックしてから呼び出します。
+void TableCache::Shrink()
+{
+	while (budget < usedBytes){
+		Erase(prev(entries.end()));
+	}
+}
+
+//! 保持するテーブルのArenaの大きさの合計の上限を設定します。上限を超えた場合は最も長く使われていないテーブルから捨てます。
+//! 新しい上限に収まる大きさのテーブルは、追加しなかった入力ファイルとして覚えていても忘れます。
+//! @param [in] bytes 上限のバイト数です。0の場合はテーブルを保持しません。
+void TableCache::SetBudget(const size_t bytes)
+{
+	lock_guard<mutex> lock(entriesMutex);
+	budget = bytes;
+	Shrink();
+	for (auto rejection = rejections.begin(); rejection != rejections.end();){
+		if (rejection->second.bytes <= budget){
+			rejection = rejections.erase(rejection);
+		}
+		else{
+			++rejection;
+		}
+	}
+}
+
+//! 保持するテーブルのArenaの大きさの合計の上限を取得します。
+//! @return 上限のバイト数です。0の場合はテーブルを保持しません。
+size_t TableCache::Budget() const
+{
+	lock_guard<mutex> lock(entriesMutex);
+	return budget;
+}
+
+//! 保持しているテーブルと追加しなかった入力ファイルを全て捨て、回数を0に戻します。
+void TableCache::Clear()
+{
+	lock_guard<mutex> lock(entriesMutex);
+	index.clear();
+	entries.clear();
+	rejections.clear();
+	usedBytes = 0;
+	hits = 0;
+	misses = 0;
+}
+
+//! Findでテーブルが見つかった回数を取得します。
+//! @return テーブルが見つかった回数です。
+size_t TableCache::Hits() const
+{
+	lock_guard<mutex> lock(entriesMutex);
+	return hits;
+}
+
+//! Findでテーブルが見つからなかった回数を取得します。
+//! @return テーブルが見つからなかった回数です。
+size_t TableCache::Misses() const
+{
+	lock_guard<mutex> lock(entriesMutex);
+	return misses;
+}
+
+//! 保持しているテーブルの数を取得します。
+//! @return 保持しているテーブルの数です。
+size_t TableCache::Size() const
+{
+	lock_guard<mutex> lock(entriesMutex);
+	return entries.size();
+}
+
+//! 保持しているテーブルのArenaの大きさの合計を取得します。
+//! @return 保持しているテーブルのArenaの大きさの合計です。
+size_t TableCache::UsedBytes() const
+{
+	lock_guard<mutex> lock(entriesMutex);
+	return usedBytes;
+}
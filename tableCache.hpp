@@ -0,0 +1,133 @@
+#pragma once
+
+#include "inputTable.hpp"
+#include "arena.hpp"
+#include "stringPool.hpp"
+
+#include <cstddef>
+#include <ctime>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+//! TableCacheが保持する、一つの入力ファイルの全ての列と全ての行を読み込んだテーブルです。
+//! 値の配列、文字列の実体、文字列に番号を振るプールは全て自身のArenaに持つので、クエリの実行や入力ファイルのマッピングとは独立して使えます。
+//! 保持した後は変更しないので、複数のスレッドから同時に読むことができます。
+class CachedTable
+{
+public:
+	Arena arena;         //!< 値の配列、文字列の実体、プールの領域を切り出すArenaです。
+	StringPool pool;     //!< テーブルの文字列の値に番号を振ったプールです。番号は値の辞書順に振り直してあります。
+	InputTable table;    //!< 読み込んだテーブルです。fileは何もマッピングしていません。
+	size_t fileSize = 0; //!< 読み込んだ時点の入力ファイルの大きさです。
+	timespec modified = {}; //!< 読み込んだ時点の入力ファイルの最終更新時刻です。
+
+	//! CachedTableクラスの新しいインスタンスを初期化します。
+	CachedTable();
+
+	CachedTable(const CachedTable&) = delete;
+	CachedTable& operator=(const CachedTable&) = delete;
+};
+
+//! 読み込んだテーブルを、入力ファイルの正規化したパスをキーとして、ExecuteSQLの呼び出しをまたいで保持するキャッシュです。
+//! 保持するテーブルのArenaの大きさの合計が上限を超えた場合は、最も長く使われていないテーブルから捨てます。
+//! 入力ファイルの大きさか最終更新時刻が読み込んだ時点と異なるテーブルは、検索の際に捨てます。
+//! テーブルだけで上限を超えたために追加しなかった入力ファイルは、大きさと最終更新時刻を覚えておき、変わるまで再び全体を読み込まないようにします。
+//! 捨てたテーブルも、使っているクエリが参照を持つ間は解放されません。全てのメソッドは複数のスレッドから同時に呼び出すことができます。
+class TableCache
+{
+	//! 最近使われた順に並べた、キーとテーブルの組です。
+	typedef std::list<std::pair<std::string, std::shared_ptr<const CachedTable>>> Entries;
+
+	//! テーブルだけで上限を超えたために追加しなかった入力ファイルです。
+	struct Rejection
+	{
+		size_t bytes;      //!< 追加しなかったテーブルのArenaの大きさです。
+		size_t fileSize;   //!< 追加しなかった時点の入力ファイルの大きさです。
+		timespec modified; //!< 追加しなかった時点の入力ファイルの最終更新時刻です。
+	};
+
+	mutable std::mutex entriesMutex;                                //!< 以下のメンバへのアクセスを排他します。
+	size_t budget;                                                  //!< 保持するテーブルのArenaの大きさの合計の上限です。
+	size_t usedBytes = 0;                                           //!< 保持しているテーブルのArenaの大きさの合計です。
+	Entries entries;                                                //!< 保持しているテーブルです。先頭が最も最近使われたものです。
+	std::unordered_map<std::string, Entries::iterator> index;      //!< キーからentriesの要素を引く表です。
+	std::unordered_map<std::string, Rejection> rejections;          //!< キーごとの、追加しなかった入力ファイルです。
+	size_t hits = 0;                                                //!< Findでテーブルが見つかった回数です。
+	size_t misses = 0;                                              //!< Findでテーブルが見つからなかった回数です。
+
+	//! テーブルを捨てます。entriesMutexをロックしてから呼び出します。
+	//! @param [in] entry 捨てるテーブルの、entriesの要素です。
+	void Erase(const Entries::iterator entry);
+
+	//! 上限を超えなくなるまで、最も長く使われていないテーブルから捨てます。entriesMutexをロックしてから呼び出します。
+	void Shrink();
+
+public:
+	static const size_t defaultBudget = 0;                          //!< プロセスで共有されるキャッシュの、初期の大きさの上限です。0の場合はテーブルを保持しません。
+
+	//! TableCacheクラスの新しいインスタンスを初期化します。
+	//! @param [in] budget 保持するテーブルのArenaの大きさの合計の上限です。0の場合はテーブルを保持しません。
+	TableCache(const size_t budget);
+
+	//! プロセスで共有されるキャッシュを取得します。
+	//! @return 初回の呼び出しで構築されたキャッシュです。
+	static TableCache& Instance();
+
+	//! 入力ファイルのパスを、キャッシュのキーとなる正規化したパスに変換します。
+	//! @param [in] path 入力ファイルのパスです。
+	//! @return 正規化したパスです。ファイルが無い場合は空文字列です。
+	static std::string Canonicalize(const std::string &path);
+
+	//! 入力ファイルを読み込んだテーブルを検索します。見つかったテーブルは最も最近使われたものとなります。
+	//! 入力ファイルの大きさか最終更新時刻が、テーブルを読み込んだ時点と異なる場合は、テーブルを捨てて見つからなかったものとします。
+	//! @param [in] key 入力ファイルの正規化したパスです。
+	//! @return 見つかったテーブルです。見つからなかった場合はnullptrを返します。
+	std::shared_ptr<const CachedTable> Find(const std::string &key);
+
+	//! 入力ファイルを読み込んだテーブルを追加します。上限を超えた場合は最も長く使われていないテーブルから捨てます。
+	//! テーブルだけで上限を超える場合は追加せず、入力ファイルを追加しなかったものとして覚えます。
+	//! @param [in] key 入力ファイルの正規化したパスです。
+	//! @param [in] table 追加するテーブルです。
+	//! @return テーブルを追加した場合はtrueです。
+	bool Add(const std::string &key, const std::shared_ptr<const CachedTable> table);
+
+	//! 入力ファイルが、テーブルだけで上限を超えたために追加しなかったものかどうかを調べます。
+	//! 入力ファイルの大きさか最終更新時刻が追加しなかった時点と異なる場合は、覚えていた入力ファイルを忘れ、追加しなかったものではないとします。
+	//! @param [in] key 入力ファイルの正規化したパスです。
+	//! @param [in] fileSize 入力ファイルの現在の大きさです。
+	//! @param [in] modified 入力ファイルの現在の最終更新時刻です。
+	//! @return 追加しなかった入力ファイルであればtrueです。
+	bool IsRejected(const std::string &key, const size_t fileSize, const timespec &modified);
+
+	//! 保持するテーブルのArenaの大きさの合計の上限を設定します。上限を超えた場合は最も長く使われていないテーブルから捨てます。
+	//! 新しい上限に収まる大きさのテーブルは、追加しなかった入力ファイルとして覚えていても忘れます。
+	//! @param [in] bytes 上限のバイト数です。0の場合はテーブルを保持しません。
+	void SetBudget(const size_t bytes);
+
+	//! 保持するテーブルのArenaの大きさの合計の上限を取得します。
+	//! @return 上限のバイト数です。0の場合はテーブルを保持しません。
+	size_t Budget() const;
+
+	//! 保持しているテーブルと追加しなかった入力ファイルを全て捨て、回数を0に戻します。
+	void Clear();
+
+	//! Findでテーブルが見つかった回数を取得します。
+	//! @return テーブルが見つかった回数です。
+	size_t Hits() const;
+
+	//! Findでテーブルが見つからなかった回数を取得します。
+	//! @return テーブルが見つからなかった回数です。
+	size_t Misses() const;
+
+	//! 保持しているテーブルの数を取得します。
+	//! @return 保持しているテーブルの数です。
+	size_t Size() const;
+
+	//! 保持しているテーブルのArenaの大きさの合計を取得します。
+	//! @return 保持しているテーブルのArenaの大きさの合計です。
+	size_t UsedBytes() const;
+};
@@ -3,9 +3,21 @@
 #include <iostream>
 #include <string>
 #include <iterator>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
 #include <gtest/gtest.h>
 
 #include "ExecuteSQL.hpp"
+#include "preparedQuery.hpp"
+#include "planCache.hpp"
+#include "arena.hpp"
+#include "charScanner.hpp"
+#include "csvScanner.hpp"
+#include "csvChunk.hpp"
+#include "columnarFile.hpp"
+#include "tableCache.hpp"
 
 //#define TestNo16 DISABLED_TestNo16
 #define TestNo17 DISABLED_TestNo17
@@ -33,7 +45,8 @@ enum REAULT_VALUE
 	ERR_WHERE_OPERAND_TYPE = 7, //!< 演算の左右の型が適切ではありません。
 	ERR_CSV_SYNTAX = 8,         //!< CSVの構文解析が失敗しました。
 	ERR_MEMORY_ALLOCATE = 9,    //!< メモリの取得に失敗しました。
-	ERR_MEMORY_OVER = 10        //!< 用意したメモリ領域の上限を超えました。
+	ERR_MEMORY_OVER = 10,       //!< 用意したメモリ領域の上限を超えました。
+	ERR_BAD_PARAMETER = 11      //!< 指定されたパラメータが存在しないか、パラメータに値が設定されていません。
 };
 
 using namespace std;
@@ -265,7 +278,7 @@ TEST_F(MyTest, TestNo11) { //ExecuteSQLは区切り文字として改行を認
 }
 TEST_F(MyTest, TestNo12) { //ExecuteSQLは認識できないトークンを含む語を指定したときERR_TOKEN_CANT_READエラーとなります。)
     const string sql =
-        "?";
+        "$";
 
     auto result = ExecuteSQL(sql, testOutputPath);
 
@@ -3056,3 +3069,1061 @@ TEST_F(MyTest, TestNo219) { //ExecuteSQLはFROMの後にスペースを挟まず
 
     ASSERT_EQ((int)ERR_SQL_SYNTAX, result);
 }
+
+TEST_F(MyTest, TestNo220) { //PreparedQueryは?で書いたパラメータの値を変えて繰り返し実行できます。
+    const string sql =
+        "SELECT * "
+        "WHERE Integer = ? "
+        "FROM TABLE1";
+
+    PreparedQuery query(sql);
+
+    query.Bind(1, 2);
+    ASSERT_EQ((int)OK, query.Execute(testOutputPath));
+    EXPECT_EQ(
+        "Integer,String"	"\n"
+        "2,B"				"\n", ReadOutput());
+
+    query.Bind(1, 3);
+    ASSERT_EQ((int)OK, query.Execute(testOutputPath));
+    EXPECT_EQ(
+        "Integer,String"	"\n"
+        "3,C"				"\n", ReadOutput());
+}
+TEST_F(MyTest, TestNo221) { //PreparedQueryは同じ名前のパラメータを複数回書くと同じ値となります。
+    const string sql =
+        "SELECT * "
+        "WHERE :value <= Integer AND Integer < :value + 2 "
+        "FROM UNORDERED";
+
+    string expectedCsv =
+        "Integer,String"	"\n"
+        "12,AB"				"\n"
+        "11,AA"				"\n";
+
+    PreparedQuery query(sql);
+    query.Bind("value", 11);
+
+    ASSERT_EQ((int)OK, query.Execute(testOutputPath));
+    EXPECT_EQ(expectedCsv, ReadOutput());
+}
+TEST_F(MyTest, TestNo222) { //PreparedQueryは文字列の値をパラメータに設定できます。
+    const string sql =
+        "SELECT * "
+        "WHERE String = ? OR Integer = ? "
+        "FROM TABLE1";
+
+    string expectedCsv =
+        "Integer,String"	"\n"
+        "1,A"				"\n"
+        "3,C"				"\n";
+
+    PreparedQuery query(sql);
+    query.Bind(1, "C");
+    query.Bind(2, 1);
+
+    ASSERT_EQ((int)OK, query.Execute(testOutputPath));
+    EXPECT_EQ(expectedCsv, ReadOutput());
+}
+TEST_F(MyTest, TestNo223) { //PreparedQueryは値が設定されていないパラメータがあるとERR_BAD_PARAMETERを返します。
+    const string sql =
+        "SELECT * "
+        "WHERE Integer = ? OR Integer = ? "
+        "FROM TABLE1";
+
+    PreparedQuery query(sql);
+    query.Bind(1, 1);
+
+    ASSERT_EQ((int)ERR_BAD_PARAMETER, query.Execute(testOutputPath));
+}
+TEST_F(MyTest, TestNo224) { //ExecuteSQLはパラメータを含むSQLを実行するとERR_BAD_PARAMETERを返します。
+    const string sql =
+        "SELECT * "
+        "WHERE Integer = :value "
+        "FROM TABLE1";
+
+    auto result = ExecuteSQL(sql, testOutputPath);
+
+    ASSERT_EQ((int)ERR_BAD_PARAMETER, result);
+}
+TEST_F(MyTest, TestNo225) { //PreparedQueryは存在しない名前や番号のパラメータに値を設定するとERR_BAD_PARAMETERを送出します。
+    const string sql =
+        "SELECT * "
+        "WHERE Integer = :value "
+        "FROM TABLE1";
+
+    PreparedQuery query(sql);
+
+    EXPECT_THROW(query.Bind("other", 1), ResultValue);
+    EXPECT_THROW(query.Bind(2, 1), ResultValue);
+    EXPECT_THROW(query.Bind(0, 1), ResultValue);
+}
+TEST_F(MyTest, TestNo226) { //PreparedQueryはマイナスを前置したパラメータの符号を反転します。
+    const string sql =
+        "SELECT * "
+        "WHERE Integer = -:value "
+        "FROM MINUS";
+
+    string expectedCsv =
+        "Integer"	"\n"
+        "-3"		"\n";
+
+    PreparedQuery query(sql);
+    query.Bind("value", 3);
+
+    ASSERT_EQ((int)OK, query.Execute(testOutputPath));
+    EXPECT_EQ(expectedCsv, ReadOutput());
+}
+TEST_F(MyTest, TestNo227) { //ExecuteSQLは:の後に名前が続かないとERR_TOKEN_CANT_READを返します。
+    const string sql =
+        "SELECT * "
+        "WHERE Integer = : "
+        "FROM TABLE1";
+
+    auto result = ExecuteSQL(sql, testOutputPath);
+
+    ASSERT_EQ((int)ERR_TOKEN_CANT_READ, result);
+}
+TEST_F(MyTest, TestNo228) { //ExecuteSQLはリテラルとキーワードの大文字小文字だけが異なるSQLの構文解析の結果を再利用します。
+    PlanCache::Instance().Clear();
+
+    ASSERT_EQ((int)OK, ExecuteSQL("SELECT * WHERE Integer = 1 OR String = 'C' FROM TABLE1", testOutputPath));
+    EXPECT_EQ(
+        "Integer,String"	"\n"
+        "1,A"				"\n"
+        "3,C"				"\n", ReadOutput());
+
+    ASSERT_EQ((int)OK, ExecuteSQL("select *  where Integer = 2 or String = 'A' from TABLE1", testOutputPath));
+    EXPECT_EQ(
+        "Integer,String"	"\n"
+        "1,A"				"\n"
+        "2,B"				"\n", ReadOutput());
+
+    EXPECT_EQ(1u, PlanCache::Instance().Misses());
+    EXPECT_EQ(1u, PlanCache::Instance().Hits());
+    EXPECT_EQ(1u, PlanCache::Instance().Size());
+}
+TEST_F(MyTest, TestNo229) { //ExecuteSQLは列名やリテラルの型が異なるSQLの構文解析の結果は再利用しません。
+    PlanCache::Instance().Clear();
+
+    ASSERT_EQ((int)OK, ExecuteSQL("SELECT * WHERE Integer = 1 FROM TABLE1", testOutputPath));
+    ASSERT_EQ((int)OK, ExecuteSQL("SELECT * WHERE String = 'A' FROM TABLE1", testOutputPath));
+    ASSERT_EQ((int)ERR_WHERE_OPERAND_TYPE, ExecuteSQL("SELECT * WHERE Integer = 'A' FROM TABLE1", testOutputPath));
+
+    EXPECT_EQ(3u, PlanCache::Instance().Misses());
+    EXPECT_EQ(0u, PlanCache::Instance().Hits());
+}
+TEST_F(MyTest, TestNo230) { //PlanCacheは上限を超えると最も長く使われていない構文解析の結果を捨てます。
+    PlanCache cache(2);
+    auto info = make_shared<const SqlQueryInfo>();
+
+    cache.Add("A", info);
+    cache.Add("B", info);
+    EXPECT_EQ(info, cache.Find("A"));
+    cache.Add("C", info);
+
+    EXPECT_EQ(2u, cache.Size());
+    EXPECT_EQ(info, cache.Find("A"));
+    EXPECT_EQ(nullptr, cache.Find("B"));
+    EXPECT_EQ(info, cache.Find("C"));
+    EXPECT_EQ(3u, cache.Hits());
+    EXPECT_EQ(1u, cache.Misses());
+}
+TEST_F(MyTest, TestNo231) { //ExecuteSQLはORDER句の列名の誤りを、行の読み込みの前に判別してERR_BAD_COLUMN_NAMEを返します。
+    const string sql =
+        "SELECT * "
+        "WHERE Integer = 'A' "
+        "ORDER BY Nothing "
+        "FROM TABLE1";
+
+    auto result = ExecuteSQL(sql, testOutputPath);
+
+    ASSERT_EQ((int)ERR_BAD_COLUMN_NAME, result);
+}
+TEST_F(MyTest, TestNo232) { //ExecuteSQLはWHERE句の式全体が真偽値とならない場合はERR_WHERE_OPERAND_TYPEを返します。
+    const string sql =
+        "SELECT * "
+        "WHERE Integer + 1 "
+        "FROM TABLE1";
+
+    auto result = ExecuteSQL(sql, testOutputPath);
+
+    ASSERT_EQ((int)ERR_WHERE_OPERAND_TYPE, result);
+}
+TEST_F(MyTest, TestNo233) { //ExecuteSQLはWHERE句の型の誤りを、条件に合う行が無くても返します。
+    const string sql =
+        "SELECT * "
+        "WHERE Integer = 0 OR String = 1 "
+        "FROM TABLE1";
+
+    auto result = ExecuteSQL(sql, testOutputPath);
+
+    ASSERT_EQ((int)ERR_WHERE_OPERAND_TYPE, result);
+}
+TEST_F(MyTest, TestNo234) { //ExecuteSQLはまとめて評価する行数を超える行を持つテーブルを、他のテーブルと組み合わせて条件で絞り込めます。
+    const string sql =
+        "SELECT TABLE1.String, MANY.Integer "
+        "WHERE MANY.Integer * 2 - TABLE1.Integer >= 4095 AND MANY.Integer <> 2500 OR MANY.Integer = -TABLE1.Integer "
+        "FROM TABLE1, MANY";
+
+    ofstream o("MANY.csv");
+    o << "Integer" << endl;
+    for (int i = 0; i <= 2500; ++i) {
+        o << (i == 0 ? -2 : i) << endl;
+    }
+    o.close();
+
+    string expectedCsv = "String,Integer\n";
+    for (auto table1 : { make_pair(1, "A"), make_pair(2, "B"), make_pair(3, "C") }) {
+        for (int i = 0; i <= 2500; ++i) {
+            int value = i == 0 ? -2 : i;
+            if ((value * 2 - table1.first >= 4095 && value != 2500) || value == -table1.first) {
+                expectedCsv += string(table1.second) + "," + to_string(value) + "\n";
+            }
+        }
+    }
+
+    auto result = ExecuteSQL(sql, testOutputPath);
+
+    ASSERT_EQ((int)OK, result);
+    EXPECT_EQ(expectedCsv, ReadOutput());
+}
+TEST_F(MyTest, TestNo235) { //PreparedQueryとExecuteSQLは同じ構文情報を共有しながら、複数のスレッドから同時に実行できます。
+    const int threadCount = 8;
+    const int repeat = 20;
+    PreparedQuery query("SELECT * WHERE Integer = ? ORDER BY Integer DESC FROM TABLE1");
+    vector<string> errors(threadCount); // スレッドごとの、期待と異なった実行結果です。
+
+    auto read = [](const string &path) {
+        ifstream ifs(path);
+        string str, ret;
+        while (getline(ifs, str)) {
+            ret += str + "\n";
+        }
+        return ret;
+    };
+
+    vector<thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.push_back(thread([&, t]() {
+            const string output = "output" + to_string(t) + ".csv";
+            const int value = t % 3 + 1;
+            const string expected = "Integer,String\n" + to_string(value) + "," + string(1, 'A' + value - 1) + "\n";
+            PreparedQuery threadQuery = query;
+            threadQuery.Bind(1, value);
+            for (int i = 0; i < repeat; ++i) {
+                if (threadQuery.Execute(output) != (int)OK || read(output) != expected) {
+                    errors[t] += "PreparedQuery ";
+                }
+                if (ExecuteSQL("SELECT * WHERE Integer = " + to_string(value) + " ORDER BY Integer DESC FROM TABLE1", output) != (int)OK || read(output) != expected) {
+                    errors[t] += "ExecuteSQL ";
+                }
+            }
+            remove(output.c_str());
+        }));
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (int t = 0; t < threadCount; ++t) {
+        EXPECT_EQ("", errors[t]) << "thread " << t;
+    }
+}
+TEST_F(MyTest, TestNo236) { //ExecuteSQLは12バイトを超える長い文字列や先頭が同じ文字列も、WHERE句とORDER句で正しく比較します。
+    const string sql =
+        "SELECT Name "
+        "WHERE Name > 'ABCDEFGHIJKLM' AND Name <> 'ABCDEFGHIJKLMNOPQ' OR Name = 'ABC' "
+        "ORDER BY Name "
+        "FROM LONG";
+
+    ofstream o("LONG.csv");
+    o
+        << "Name" << endl
+        << "ABCDEFGHIJKLMNOPQ" << endl
+        << "ABC" << endl
+        << "ABCDEFGHIJKLMNOPQRSTUVWXYZ" << endl
+        << "ABCD" << endl
+        << "ABCDEFGHIJKLM" << endl
+        << "ABCDEFGHIJKLMNOPP" << endl
+        << "ABCE" << endl
+        << "ABCDEFGHIJKL" << endl;
+    o.close();
+
+    auto result = ExecuteSQL(sql, testOutputPath);
+
+    ASSERT_EQ((int)OK, result);
+    EXPECT_EQ(
+        "Name\n"
+        "ABC\n"
+        "ABCDEFGHIJKLMNOPP\n"
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZ\n"
+        "ABCE\n",
+        ReadOutput());
+}
+TEST_F(MyTest, TestNo237) { //PreparedQueryのコピーは、コピー元が破棄されても長い文字列のパラメータで実行できます。
+    const string sql =
+        "SELECT Name "
+        "WHERE Name = ? "
+        "FROM LONG";
+
+    ofstream o("LONG.csv");
+    o
+        << "Name" << endl
+        << "ABCDEFGHIJKLMNOPQ" << endl
+        << "ABCDEFGHIJKLMNOPP" << endl;
+    o.close();
+
+    auto original = make_unique<PreparedQuery>(sql);
+    original->Bind(1, string("ABCDEFGHIJKLMNOPP"));
+    PreparedQuery copied = *original;
+    original.reset();
+
+    ASSERT_EQ((int)OK, copied.Execute(testOutputPath));
+    EXPECT_EQ(
+        "Name"				"\n"
+        "ABCDEFGHIJKLMNOPP"	"\n", ReadOutput());
+}
+TEST_F(MyTest, TestNo238) { //ExecuteSQLはヘッダ行より列の少ないデータ行の残りの列を空文字列とし、多い列は読み飛ばします。
+    const string sql =
+        "SELECT * "
+        "WHERE Second <> 'X' "
+        "FROM UNEVEN";
+
+    ofstream o("UNEVEN.csv");
+    o
+        << "First,Second" << endl
+        << "A" << endl
+        << "B,C,D" << endl
+        << "E,X" << endl;
+    o.close();
+
+    auto result = ExecuteSQL(sql, testOutputPath);
+
+    ASSERT_EQ((int)OK, result);
+    EXPECT_EQ(
+        "First,Second"	"\n"
+        "A,"			"\n"
+        "B,C"			"\n",
+        ReadOutput());
+}
+TEST_F(MyTest, TestNo239) { //Arenaは塊をまたいでも、アラインメントを満たす重ならない領域を切り出します。
+    Arena arena;
+    ArenaVector<long long> values(arena);
+    for (int i = 0; i < 1000000; ++i) {
+        values.push_back(i);
+    }
+    auto small = static_cast<char*>(arena.Allocate(1, 1));
+    auto aligned = arena.Allocate(64, 64);
+
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(values.data()) % alignof(long long));
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(aligned) % 64);
+    EXPECT_TRUE(small < reinterpret_cast<char*>(values.data()) || reinterpret_cast<char*>(values.data() + values.size()) <= small);
+    for (int i = 0; i < 1000000; ++i) {
+        ASSERT_EQ(i, values[i]);
+    }
+}
+TEST_F(MyTest, TestNo240) { //ExecuteSQLは異なるテーブルの文字列の列同士や、どの行にも無い文字列との＝と＜＞を評価できます。
+    const string sql =
+        "SELECT OWNERS.Name, ITEMS.Name "
+        "WHERE OWNERS.Status = ITEMS.Status AND ITEMS.Status <> 'CLOSED' AND OWNERS.Name <> 'NONE' "
+        "FROM OWNERS, ITEMS";
+
+    ofstream o("OWNERS.csv");
+    o
+        << "Name,Status" << endl
+        << "P1,OPEN" << endl
+        << "P2,CLOSED" << endl
+        << "P3,PENDING" << endl;
+    o.close();
+    o = ofstream("ITEMS.csv");
+    o
+        << "Name,Status" << endl
+        << "C1,PENDING" << endl
+        << "C2,OPEN" << endl
+        << "C3,CLOSED" << endl
+        << "C4,OPEN" << endl;
+    o.close();
+
+    auto result = ExecuteSQL(sql, testOutputPath);
+
+    ASSERT_EQ((int)OK, result);
+    EXPECT_EQ(
+        "Name,Name"	"\n"
+        "P1,C2"		"\n"
+        "P1,C4"		"\n"
+        "P3,C1"		"\n",
+        ReadOutput());
+}
+TEST_F(MyTest, TestNo241) { //ExecuteSQLは異なる値の多い文字列の列も、＝と＜＞と＜で評価できます。
+    const string sql =
+        "SELECT Id "
+        "WHERE Name = 'NAME4999' OR Name = 'NAME7' OR Name < 'NAME1' AND Name <> 'NAME0' "
+        "FROM MANY";
+
+    ofstream o("MANY.csv");
+    o << "Id,Name" << endl;
+    for (int i = 0; i < 6000; ++i) {
+        o << i << ",NAME" << i << endl;
+    }
+    o.close();
+
+    auto result = ExecuteSQL(sql, testOutputPath);
+
+    ASSERT_EQ((int)OK, result);
+    EXPECT_EQ(
+        "Id"	"\n"
+        "7"		"\n"
+        "4999"	"\n",
+        ReadOutput());
+}
+TEST_F(MyTest, TestNo242) { //ExecuteSQLは文字列の列と、列に無い文字列との大小を、定数が左右どちらにあっても比較できます。
+    const string sql =
+        "SELECT Name "
+        "WHERE Name >= 'B' AND 'DA' > Name OR Name <= 'AB' AND Name > 'A' "
+        "ORDER BY Name DESC "
+        "FROM CODES";
+
+    ofstream o("CODES.csv");
+    o
+        << "Name" << endl
+        << "D" << endl
+        << "BB" << endl
+        << "AA" << endl
+        << "C" << endl
+        << "A" << endl
+        << "B" << endl
+        << "DA" << endl
+        << "AC" << endl;
+    o.close();
+
+    auto result = ExecuteSQL(sql, testOutputPath);
+
+    ASSERT_EQ((int)OK, result);
+    EXPECT_EQ(
+        "Name"	"\n"
+        "D"		"\n"
+        "C"		"\n"
+        "BB"	"\n"
+        "B"		"\n"
+        "AA"	"\n",
+        ReadOutput());
+}
+TEST_F(MyTest, TestNo243) { //ExecuteSQLは改行で終わらない最後の行も読み込み、空の行は全ての列が空文字列の行とします。
+    const string sql =
+        "SELECT Name, Value "
+        "WHERE Value <> 'X' "
+        "FROM NOLASTNEWLINE";
+
+    ofstream o("NOLASTNEWLINE.csv");
+    o
+        << "Name,Value" << endl
+        << "A,1" << endl
+        << endl
+        << "B,X" << endl
+        << "C,3";
+    o.close();
+
+    auto result = ExecuteSQL(sql, testOutputPath);
+
+    ASSERT_EQ((int)OK, result);
+    EXPECT_EQ(
+        "Name,Value"	"\n"
+        "A,1"			"\n"
+        ","				"\n"
+        "C,3"			"\n",
+        ReadOutput());
+}
+TEST_F(MyTest, TestNo244) { //ExecuteSQLは空の入力ファイルを、ヘッダ行が無いものとしてエラーにします。
+    const string sql =
+        "SELECT * "
+        "FROM EMPTY";
+
+    ofstream o("EMPTY.csv");
+    o.close();
+
+    auto result = ExecuteSQL(sql, testOutputPath);
+
+    ASSERT_EQ((int)ERR_CSV_SYNTAX, result);
+}
+TEST_F(MyTest, TestNo245) { //CsvScannerの全ての実装は、ブロック中のカンマと改行文字の位置を同じビットマスクで返します。
+    string block(CsvScanner::blockSize, 'a');
+    block[0] = ',';
+    block[15] = '\n';
+    block[16] = ',';
+    block[31] = ',';
+    block[32] = '\n';
+    block[47] = '\r';
+    block[62] = ',';
+    block[63] = '\n';
+
+    auto scalar = CsvScanner::ScanScalar(block.data());
+    EXPECT_EQ(0x4000000080010001ull, scalar.commas);
+    EXPECT_EQ(0x8000000100008000ull, scalar.newLines);
+
+    auto sse2 = CsvScanner::ScanSse2(block.data());
+    EXPECT_EQ(scalar.commas, sse2.commas);
+    EXPECT_EQ(scalar.newLines, sse2.newLines);
+
+    if (CsvScanner::SupportsAvx2()) {
+        auto avx2 = CsvScanner::ScanAvx2(block.data());
+        EXPECT_EQ(scalar.commas, avx2.commas);
+        EXPECT_EQ(scalar.newLines, avx2.newLines);
+    }
+
+    auto selected = CsvScanner::Scan(block.data());
+    EXPECT_EQ(scalar.commas, selected.commas);
+    EXPECT_EQ(scalar.newLines, selected.newLines);
+}
+TEST_F(MyTest, TestNo246) { //ExecuteSQLは64バイトのブロックをまたぐ値や行を読み込めます。
+    const string sql =
+        "SELECT Id, Name "
+        "WHERE Id > 1 "
+        "FROM WIDE";
+
+    const string longName(100, 'N');
+    ofstream o("WIDE.csv");
+    o << "Id,Name" << endl;
+    for (int i = 1; i <= 5; ++i) {
+        o << i << "," << longName << i << endl;
+    }
+    o << "6," << longName;
+    o.close();
+
+    auto result = ExecuteSQL(sql, testOutputPath);
+
+    ASSERT_EQ((int)OK, result);
+    EXPECT_EQ(
+        "Id,Name"					"\n"
+        "2," + longName + "2"		"\n"
+        "3," + longName + "3"		"\n"
+        "4," + longName + "4"		"\n"
+        "5," + longName + "5"		"\n"
+        "6," + longName +			"\n",
+        ReadOutput());
+}
+TEST_F(MyTest, TestNo247) { //CsvChunkは改行文字の直後で区切った範囲ごとに読み込んでも、つなげると区切らずに読み込んだ結果と同じ行と値になります。
+    string csv;
+    for (int i = 0; i < 1000; ++i) {
+        csv += to_string(i) + (i % 7 ? ",A" + to_string(i) : string()) + (i % 11 ? "" : ",X,Y") + "\n";
+    }
+    csv += "-1,LAST";
+
+    CsvChunk whole;
+    whole.Parse(csv.data(), csv.data() + csv.size(), vector<char>(2, true));
+    ASSERT_EQ(1001, whole.rowCount);
+    EXPECT_EQ("0", whole.columns[0][0]);
+    EXPECT_EQ("", whole.columns[1][7]);
+    EXPECT_EQ("A1", whole.columns[1][1]);
+    EXPECT_EQ("LAST", whole.columns[1][1000]);
+
+    auto boundaries = CsvChunk::Split(csv.data(), csv.data() + csv.size(), 5);
+    ASSERT_EQ(6u, boundaries.size());
+    EXPECT_EQ(csv.data(), boundaries.front());
+    EXPECT_EQ(csv.data() + csv.size(), boundaries.back());
+
+    vector<string_view> first, second;
+    int rowCount = 0;
+    for (int k = 0; k < 5; ++k) {
+        ASSERT_TRUE(boundaries[k] == csv.data() || boundaries[k][-1] == '\n');
+        CsvChunk chunk;
+        chunk.Parse(boundaries[k], boundaries[k + 1], vector<char>(2, true));
+        first.insert(first.end(), chunk.columns[0].begin(), chunk.columns[0].end());
+        second.insert(second.end(), chunk.columns[1].begin(), chunk.columns[1].end());
+        rowCount += chunk.rowCount;
+    }
+    EXPECT_EQ(whole.rowCount, rowCount);
+    EXPECT_EQ(whole.columns[0], first);
+    EXPECT_EQ(whole.columns[1], second);
+}
+TEST_F(MyTest, TestNo248) { //ExecuteSQLはintに収まらない値、空文字列、符号の位置が誤った値を含む列を、例外を投げずに文字列型の列として読み込みます。
+    const string sql =
+        "SELECT * "
+        "ORDER BY Signed "
+        "FROM NUMBERS";
+
+    ofstream o("NUMBERS.csv");
+    o
+        << "Signed,Overflow,Blank,Misplaced" << endl
+        << "+5,10,1,1" << endl
+        << "-3,9,,2-1" << endl
+        << "12,99999999999,3,+-4" << endl
+        << "-2147483648,-2147483649,4,5" << endl;
+    o.close();
+
+    auto result = ExecuteSQL(sql, testOutputPath);
+
+    ASSERT_EQ((int)OK, result);
+    EXPECT_EQ(
+        "Signed,Overflow,Blank,Misplaced"	"\n"
+        "-2147483648,-2147483649,4,5"		"\n"
+        "-3,9,,2-1"							"\n"
+        "5,10,1,1"							"\n"
+        "12,99999999999,3,+-4"				"\n",
+        ReadOutput());
+
+    const string stringOrder =
+        "SELECT Overflow, Blank, Misplaced "
+        "WHERE Overflow > '1' AND Blank < '4' AND Misplaced <> '5' "
+        "ORDER BY Overflow "
+        "FROM NUMBERS";
+
+    result = ExecuteSQL(stringOrder, testOutputPath);
+
+    ASSERT_EQ((int)OK, result);
+    EXPECT_EQ(
+        "Overflow,Blank,Misplaced"	"\n"
+        "10,1,1"					"\n"
+        "9,,2-1"					"\n"
+        "99999999999,3,+-4"			"\n",
+        ReadOutput());
+}
+TEST_F(MyTest, TestNo249) { //ExecuteSQLはSELECT句に無くWHERE句やORDER句だけで参照される列も読み込み、参照されない列があっても正しく出力します。
+    const string sql =
+        "SELECT PARENTS.Name, Note "
+        "WHERE PARENTS.Id = ParentId AND Age > 3 "
+        "ORDER BY Rank DESC "
+        "FROM PARENTS, CHILDREN";
+
+    ofstream parents("PARENTS.csv");
+    parents
+        << "Id,Name,Unused1,Unused2" << endl
+        << "1,P1,x,-" << endl
+        << "2,P2,y,+" << endl;
+    parents.close();
+
+    ofstream children("CHILDREN.csv");
+    children
+        << "Unused3,ParentId,Age,Note,Rank" << endl
+        << "a,1,5,N1,1" << endl
+        << "b,2,2,N2,3" << endl
+        << "c,2,9,N3,2" << endl
+        << "d,1,4,N4,4" << endl;
+    children.close();
+
+    auto result = ExecuteSQL(sql, testOutputPath);
+
+    ASSERT_EQ((int)OK, result);
+    EXPECT_EQ(
+        "Name,Note"	"\n"
+        "P1,N4"		"\n"
+        "P2,N3"		"\n"
+        "P1,N1"		"\n",
+        ReadOutput());
+
+    EXPECT_EQ((int)ERR_BAD_COLUMN_NAME, ExecuteSQL("SELECT Name WHERE Missing = 1 FROM PARENTS", testOutputPath));
+}
+TEST_F(MyTest, TestNo250) { //ExecuteSQLは一つのテーブルだけを参照するWHERE句の条件でテーブルを読む際に絞り込み、残りの条件と合わせて正しく出力します。
+    const string sql =
+        "SELECT PARENTS.Name, Note, Code "
+        "WHERE PARENTS.Id = ParentId AND Age > 3 AND Flag = 1 AND (Code <> '7' OR Rank < 2) "
+        "ORDER BY Code, Rank DESC "
+        "FROM PARENTS, CHILDREN";
+
+    ofstream parents("PARENTS.csv");
+    parents
+        << "Id,Name,Flag" << endl
+        << "1,P1,1" << endl
+        << "2,P2,0" << endl
+        << "3,P3,1" << endl;
+    parents.close();
+
+    ofstream children("CHILDREN.csv");
+    children
+        << "ParentId,Age,Note,Rank,Code" << endl
+        << "1,5,N1,1,9" << endl
+        << "3,2,N2,3,10" << endl
+        << "3,9,N3,2,10" << endl
+        << "1,4,N4,4,10" << endl
+        << "2,8,N5,5,9" << endl
+        << "1,1,N6,6,X" << endl
+        << "3,6,N7,7,7" << endl;
+    children.close();
+
+    auto result = ExecuteSQL(sql, testOutputPath);
+
+    // 条件に合う行のCodeは全て数字ですが、条件に合わない行を含めると文字列型の列なので、辞書順に並びます。
+    ASSERT_EQ((int)OK, result);
+    EXPECT_EQ(
+        "Name,Note,Code"	"\n"
+        "P1,N4,10"		"\n"
+        "P3,N3,10"		"\n"
+        "P1,N1,9"		"\n",
+        ReadOutput());
+
+    EXPECT_EQ((int)ERR_WHERE_OPERAND_TYPE, ExecuteSQL("SELECT Name WHERE Flag = 1 AND Name > 1 FROM PARENTS", testOutputPath));
+}
+TEST_F(MyTest, TestNo251) { //ExecuteSQLはORDER句の無いクエリで一度に読み込む大きさを超える先頭のテーブルを少しずつ読み込んでも、全ての値で判断した列の型で正しく出力します。
+    // 小さなテーブルも少しずつ読み込むようにし、一度に読み込む大きさを超えるように、最後の行だけCodeが整数ではないテーブルを作ります。
+    SqlQuery::SetMinStreamBytes(0);
+    const int rowCount = 400000;
+    string big = "Id,Code,Note\n";
+    for (int i = 0; i < rowCount; ++i) {
+        big += to_string(i) + ",+" + to_string(i) + ",NOTE_" + to_string(i % 1000) + "\n";
+    }
+    big += "-1,X,LAST\n";
+    ofstream("BIG.csv") << big;
+    big = string();
+
+    ofstream("SMALL.csv")
+        << "Ref,Name" << endl
+        << "399998,S1" << endl
+        << "1,S2" << endl;
+
+    // Codeは文字列型の列なので、先頭の行も+の付いたまま出力します。
+    auto result = ExecuteSQL("SELECT Id, Code, Note WHERE Id < 2 OR Id > 399998 FROM BIG", testOutputPath);
+    ASSERT_EQ((int)OK, result);
+    EXPECT_EQ(
+        "Id,Code,Note"		"\n"
+        "0,+0,NOTE_0"		"\n"
+        "1,+1,NOTE_1"		"\n"
+        "399999,+399999,NOTE_999"	"\n"
+        "-1,X,LAST"		"\n",
+        ReadOutput());
+
+    // 先頭のテーブルの行の順に、他のテーブルの行と組み合わせて出力します。
+    result = ExecuteSQL("SELECT Id, Name WHERE Id = Ref AND (Id < 10 OR Id > 399990) FROM BIG, SMALL", testOutputPath);
+    ASSERT_EQ((int)OK, result);
+    EXPECT_EQ(
+        "Id,Name"		"\n"
+        "1,S2"			"\n"
+        "399998,S1"	"\n",
+        ReadOutput());
+
+    // 最後の行で文字列型と判断された列の型の誤りは、出力する前に検出します。
+    EXPECT_EQ((int)ERR_WHERE_OPERAND_TYPE, ExecuteSQL("SELECT Id WHERE Code > 1 FROM BIG", testOutputPath));
+
+    // 少しずつ読み込む先頭のテーブルは、一度に読み込む大きさより小さくても正しく出力します。
+    ASSERT_EQ((int)OK, ExecuteSQL("SELECT Name WHERE Ref > 1 FROM SMALL", testOutputPath));
+    EXPECT_EQ("Name\nS1\n", ReadOutput());
+
+    SqlQuery::SetMinStreamBytes(SqlQuery::defaultMinStreamBytes);
+    remove("BIG.csv");
+}
+TEST_F(MyTest, TestNo252) { //ExecuteSQLはサイドカーファイルを有効にすると初回にCSVから作成し、CSVの大きさ、更新時刻、内容が一致する間はサイドカーファイルから読み込みます。
+    const string sql = "SELECT Id, Name, Code WHERE Code > '5' AND Id <> 2 ORDER BY Id DESC FROM COLUMNAR";
+    const string sidecarPath = string("COLUMNAR.csv") + ColumnarFile::extension;
+    remove(sidecarPath.c_str());
+    ofstream("COLUMNAR.csv")
+        << "Id,Name,Code" << endl
+        << "1,A,7" << endl
+        << "2,B,9" << endl
+        << "3,C,X" << endl
+        << "4,,8" << endl;
+    ColumnarFile::Enable(true);
+
+    // 初回はCSVから読み込んでサイドカーファイルを作成し、二回目はサイドカーファイルから読み込みます。
+    for (int i = 0; i < 2; ++i) {
+        auto result = ExecuteSQL(sql, testOutputPath);
+        ASSERT_EQ((int)OK, result);
+        EXPECT_EQ(
+            "Id,Name,Code"	"\n"
+            "4,,8"			"\n"
+            "3,C,X"			"\n"
+            "1,A,7"			"\n",
+            ReadOutput());
+        EXPECT_TRUE(ifstream(sidecarPath).good());
+    }
+
+    // サイドカーファイルに記録した、全ての行の値で判断した列の型を使います。
+    EXPECT_EQ((int)ERR_WHERE_OPERAND_TYPE, ExecuteSQL("SELECT Id WHERE Code > 1 FROM COLUMNAR", testOutputPath));
+    ASSERT_EQ((int)OK, ExecuteSQL("SELECT Id WHERE Id * 2 > 5 FROM COLUMNAR", testOutputPath));
+    EXPECT_EQ("Id\n3\n4\n", ReadOutput());
+
+    // 大きさと更新時刻が同じでも、内容が変わったCSVからはサイドカーファイルを作り直します。
+    struct stat status;
+    ASSERT_EQ(0, stat("COLUMNAR.csv", &status));
+    ofstream("COLUMNAR.csv")
+        << "Id,Name,Code" << endl
+        << "1,A,7" << endl
+        << "2,B,9" << endl
+        << "3,C,Y" << endl
+        << "4,,8" << endl;
+    const timespec times[2] = { status.st_atim, status.st_mtim };
+    ASSERT_EQ(0, utimensat(AT_FDCWD, "COLUMNAR.csv", times, 0));
+    ASSERT_EQ((int)OK, ExecuteSQL(sql, testOutputPath));
+    EXPECT_EQ(
+        "Id,Name,Code"	"\n"
+        "4,,8"			"\n"
+        "3,C,Y"			"\n"
+        "1,A,7"			"\n",
+        ReadOutput());
+
+    // 辞書の値の終了位置が前の値より前にあるか、番号が辞書に収まらないサイドカーファイルは、使わずに作り直します。
+    const streamoff entryOffsets[] = { 56 + 48 * 1 + 32, 56 + 48 * 2 + 8 }; // Name列の辞書の終了位置の配列と、Code列の番号の配列の位置を記録した場所です。
+    for (auto entryOffset : entryOffsets) {
+        {
+            fstream sidecar(sidecarPath, ios::in | ios::out | ios::binary);
+            uint64_t arrayOffset = 0;
+            sidecar.seekg(entryOffset);
+            ASSERT_TRUE(sidecar.read(reinterpret_cast<char*>(&arrayOffset), sizeof(arrayOffset)));
+            const uint64_t broken = uint64_t(1) << 40;
+            sidecar.seekp(arrayOffset);
+            ASSERT_TRUE(sidecar.write(reinterpret_cast<const char*>(&broken), sizeof(broken)));
+        }
+        ASSERT_EQ((int)OK, ExecuteSQL("SELECT Name, Code WHERE Id < 4 FROM COLUMNAR", testOutputPath));
+        EXPECT_EQ("Name,Code\nA,7\nB,9\nC,Y\n", ReadOutput());
+    }
+
+    // 壊れたサイドカーファイルは使わずに作り直します。
+    ofstream(sidecarPath) << "TCOL";
+    ASSERT_EQ((int)OK, ExecuteSQL("SELECT Name WHERE Id = 3 FROM COLUMNAR", testOutputPath));
+    EXPECT_EQ("Name\nC\n", ReadOutput());
+
+    ColumnarFile::Enable(false);
+    remove(sidecarPath.c_str());
+}
+TEST_F(MyTest, TestNo253) { //ExecuteSQLはテーブルのキャッシュを有効にすると、読み込んだテーブルを保持し、CSVの大きさか更新時刻が変わるまで再利用します。
+    auto &cache = TableCache::Instance();
+    cache.SetBudget(64 << 20);
+    cache.Clear();
+    ofstream("PEOPLE.csv")
+        << "Id,Name,Pet" << endl
+        << "1,Carol,Rex" << endl
+        << "2,Alice,Tama" << endl
+        << "3,Bob,Pochi" << endl;
+    ofstream("PETS.csv")
+        << "Name,Kind" << endl
+        << "Tama,Cat" << endl
+        << "Rex,Dog" << endl
+        << "Pochi,Dog" << endl;
+
+    // 初回はCSVから読み込んでキャッシュに追加し、二回目はキャッシュから読み込みます。
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_EQ((int)OK, ExecuteSQL("SELECT Name WHERE Name > 'Alice' AND Id <> 1 FROM PEOPLE", testOutputPath));
+        EXPECT_EQ("Name\nBob\n", ReadOutput());
+    }
+    EXPECT_EQ(1u, cache.Misses());
+    EXPECT_EQ(1u, cache.Hits());
+    EXPECT_EQ(1u, cache.Size());
+
+    // プールの異なるテーブルの文字列同士も、値で比較します。
+    ASSERT_EQ((int)OK, ExecuteSQL("SELECT PEOPLE.Name, PETS.Kind WHERE PEOPLE.Pet = PETS.Name ORDER BY PEOPLE.Name FROM PEOPLE, PETS", testOutputPath));
+    EXPECT_EQ("Name,Kind\nAlice,Cat\nBob,Dog\nCarol,Dog\n", ReadOutput());
+    EXPECT_EQ(2u, cache.Size());
+
+    // 大きさの変わったCSVは読み込み直します。
+    ofstream("PEOPLE.csv")
+        << "Id,Name,Pet" << endl
+        << "1,Carol,Rex" << endl
+        << "2,Dave,Tama" << endl;
+    auto misses = cache.Misses();
+    ASSERT_EQ((int)OK, ExecuteSQL("SELECT Name ORDER BY Name FROM PEOPLE", testOutputPath));
+    EXPECT_EQ("Name\nCarol\nDave\n", ReadOutput());
+    EXPECT_EQ(misses + 1, cache.Misses());
+
+    // 複数のスレッドから同時にキャッシュのテーブルを読み込めます。
+    vector<thread> threads;
+    vector<int> failures(4); // スレッドごとの、期待と異なった実行結果の数です。
+    for (size_t t = 0; t < failures.size(); ++t) {
+        threads.push_back(thread([&, t]() {
+            auto output = "output" + to_string(t) + ".csv";
+            for (int i = 0; i < 50; ++i) {
+                if (ExecuteSQL("SELECT Kind WHERE Name = 'Rex' FROM PETS", output) != (int)OK ||
+                    string(istreambuf_iterator<char>(ifstream(output).rdbuf()), istreambuf_iterator<char>()) != "Kind\nDog\n") {
+                    ++failures[t];
+                }
+            }
+            remove(output.c_str());
+        }));
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(vector<int>(failures.size()), failures);
+
+    // 上限を超えると、最も長く使われていないテーブルから捨てます。
+    cache.SetBudget(cache.UsedBytes() - 1);
+    EXPECT_EQ(1u, cache.Size());
+
+    cache.SetBudget(0);
+    cache.Clear();
+    EXPECT_EQ(0u, cache.Size());
+}
+TEST_F(MyTest, TestNo254) { //PreparedQueryはマイナスを前置したパラメータに文字列の値を設定するとERR_WHERE_OPERAND_TYPEを返します。
+    const string sql =
+        "SELECT * "
+        "WHERE String = -? "
+        "FROM TABLE1";
+
+    PreparedQuery query(sql);
+    query.Bind(1, "C");
+
+    ASSERT_EQ((int)ERR_WHERE_OPERAND_TYPE, query.Execute(testOutputPath));
+
+    query.Bind(1, 3);
+    ASSERT_EQ((int)ERR_WHERE_OPERAND_TYPE, query.Execute(testOutputPath));
+}
+TEST_F(MyTest, TestNo255) { //ExecuteSQLはサイドカーファイルの異なる値が多い列と少ない列を、マッピングした領域を参照したまま比較し、並べ替え、他のテーブルの列と結合します。
+    const string sql =
+        "SELECT MANYVALUES.Id, MANYVALUES.Name, LABELS.Label "
+        "WHERE MANYVALUES.Kind = 'C1' AND MANYVALUES.Id < 10 AND MANYVALUES.Kind = LABELS.Kind "
+        "ORDER BY MANYVALUES.Name DESC "
+        "FROM MANYVALUES, LABELS";
+    const string sidecarPaths[] = { string("MANYVALUES.csv") + ColumnarFile::extension, string("LABELS.csv") + ColumnarFile::extension };
+    for (auto &path : sidecarPaths) {
+        remove(path.c_str());
+    }
+    {
+        ofstream manyValues("MANYVALUES.csv");
+        manyValues << "Id,Name,Kind" << endl;
+        for (int i = 0; i < 5000; ++i) {
+            manyValues << i << ",N" << 10000 + i << ",C" << i % 3 << endl;
+        }
+    }
+    ofstream("LABELS.csv")
+        << "Kind,Label" << endl
+        << "C0,Zero" << endl
+        << "C1,One" << endl;
+    ColumnarFile::Enable(true);
+
+    // 初回はCSVから読み込んでサイドカーファイルを作成し、二回目はサイドカーファイルから読み込みます。
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_EQ((int)OK, ExecuteSQL(sql, testOutputPath));
+        EXPECT_EQ(
+            "Id,Name,Label"	"\n"
+            "7,N10007,One"	"\n"
+            "4,N10004,One"	"\n"
+            "1,N10001,One"	"\n",
+            ReadOutput());
+    }
+
+    // 条件の無いテーブルも、全ての行をサイドカーファイルから読み込みます。
+    ASSERT_EQ((int)OK, ExecuteSQL("SELECT Name WHERE Name >= 'N14998' FROM MANYVALUES", testOutputPath));
+    EXPECT_EQ("Name\nN14998\nN14999\n", ReadOutput());
+
+    ColumnarFile::Enable(false);
+    for (auto &path : sidecarPaths) {
+        remove(path.c_str());
+    }
+    remove("MANYVALUES.csv");
+    remove("LABELS.csv");
+}
+TEST_F(MyTest, TestNo256) { //ExecuteSQLはWHERE句のカッコが深く入れ子になっていても、スタックを溢れさせずに読み込みます。
+    const int depth = 100000;
+    const string sql = "SELECT String WHERE " + string(depth, '(') + "Integer = 2" + string(depth, ')') + " FROM TABLE1";
+
+    ASSERT_EQ((int)OK, ExecuteSQL(sql, testOutputPath));
+    EXPECT_EQ("String\nB\n", ReadOutput());
+
+    // 閉じられていないカッコが深く残っていてもERR_SQL_SYNTAXとなります。
+    EXPECT_EQ((int)ERR_SQL_SYNTAX, ExecuteSQL("SELECT String WHERE " + string(depth, '(') + "Integer = 2 FROM TABLE1", testOutputPath));
+}
+TEST_F(MyTest, TestNo257) { //ExecuteSQLはカッコでくくった一つのオペランドの右の演算子を、カッコの外の演算子として優先順位に従って結合します。
+    const string sql =
+        "SELECT Integer "
+        "WHERE Integer * (Integer) + 1 = 5 "
+        "FROM TABLE1";
+
+    // Integer * ((Integer) + 1)ではなく、(Integer * (Integer)) + 1として評価します。
+    ASSERT_EQ((int)OK, ExecuteSQL(sql, testOutputPath));
+    EXPECT_EQ("Integer\n2\n", ReadOutput());
+}
+TEST_F(MyTest, TestNo258) { //ExecuteSQLはWHERE句のカッコの開始と終了が対応していないとERR_SQL_SYNTAXエラーとなります。
+    EXPECT_EQ((int)ERR_SQL_SYNTAX, ExecuteSQL("SELECT * WHERE (Integer = 1 FROM TABLE1", testOutputPath));
+    EXPECT_EQ((int)ERR_SQL_SYNTAX, ExecuteSQL("SELECT * WHERE ((Integer = 1) FROM TABLE1", testOutputPath));
+    EXPECT_EQ((int)ERR_SQL_SYNTAX, ExecuteSQL("SELECT * WHERE Integer = 1) FROM TABLE1", testOutputPath));
+    EXPECT_EQ((int)ERR_SQL_SYNTAX, ExecuteSQL("SELECT * WHERE (Integer = 1)) FROM TABLE1", testOutputPath));
+}
+TEST_F(MyTest, TestNo259) { //ExecuteSQLはWHERE句に非常に多くの条件をORでつないでも、スタックを溢れさせずに評価します。
+    string sql = "SELECT String WHERE Integer = 3";
+    for (int i = 0; i < 100000; ++i) {
+        sql += " OR Integer = " + to_string(10 + i);
+    }
+    sql += " FROM TABLE1";
+
+    ASSERT_EQ((int)OK, ExecuteSQL(sql, testOutputPath));
+    EXPECT_EQ("String\nC\n", ReadOutput());
+}
+TEST_F(MyTest, TestNo260) { //CharScannerの全ての実装は、16バイトと32バイトの境界をまたぐ並びでも同じ位置を返します。
+    typedef const char* (*Skip)(const char *cursol, const char *end);
+    struct Case {
+        Skip scalar;
+        Skip sse2;
+        Skip avx2;
+        Skip selected;
+        char match; // 読み飛ばされる文字です。
+        char stop; // 並びを終わらせる文字です。
+    };
+    const Case cases[] = {
+        { CharScanner::SkipSpacesScalar, CharScanner::SkipSpacesSse2, CharScanner::SkipSpacesAvx2, CharScanner::SkipSpaces, ' ', 'a' },
+        { CharScanner::SkipSpacesScalar, CharScanner::SkipSpacesSse2, CharScanner::SkipSpacesAvx2, CharScanner::SkipSpaces, '\n', '0' },
+        { CharScanner::SkipDigitsScalar, CharScanner::SkipDigitsSse2, CharScanner::SkipDigitsAvx2, CharScanner::SkipDigits, '0', '/' },
+        { CharScanner::SkipDigitsScalar, CharScanner::SkipDigitsSse2, CharScanner::SkipDigitsAvx2, CharScanner::SkipDigits, '9', ':' },
+        { CharScanner::SkipIdentifierPartScalar, CharScanner::SkipIdentifierPartSse2, CharScanner::SkipIdentifierPartAvx2, CharScanner::SkipIdentifierPart, 'x', 'y' },
+        { CharScanner::SkipIdentifierPartScalar, CharScanner::SkipIdentifierPartSse2, CharScanner::SkipIdentifierPartAvx2, CharScanner::SkipIdentifierPart, 'Y', 'y' },
+        { CharScanner::SkipIdentifierPartScalar, CharScanner::SkipIdentifierPartSse2, CharScanner::SkipIdentifierPartAvx2, CharScanner::SkipIdentifierPart, 'z', '{' },
+        { CharScanner::SkipIdentifierPartScalar, CharScanner::SkipIdentifierPartSse2, CharScanner::SkipIdentifierPartAvx2, CharScanner::SkipIdentifierPart, '_', ' ' },
+        { CharScanner::FindQuoteScalar, CharScanner::FindQuoteSse2, CharScanner::FindQuoteAvx2, CharScanner::FindQuote, 'y', '\'' },
+    };
+
+    for (auto &testCase : cases) {
+        for (int length = 0; length <= 70; ++length) {
+            // 並びを終わらせる文字がある場合と、範囲の終わりまで並びが続く場合を調べます。
+            // 終わらせる文字の後にも読み飛ばされる文字を置き、終わらせる文字がブロックの中に入るようにします。
+            for (int withStop = 0; withStop <= 1; ++withStop) {
+                string text(length, testCase.match);
+                if (withStop) {
+                    text += testCase.stop;
+                    text += string(40, testCase.match);
+                }
+                auto begin = text.data();
+                auto end = text.data() + text.size();
+                SCOPED_TRACE("match=" + to_string(testCase.match) + " length=" + to_string(length) + " withStop=" + to_string(withStop));
+
+                EXPECT_EQ(begin + length, testCase.scalar(begin, end));
+                EXPECT_EQ(begin + length, testCase.sse2(begin, end));
+                if (CharScanner::SupportsAvx2()) {
+                    EXPECT_EQ(begin + length, testCase.avx2(begin, end));
+                }
+                EXPECT_EQ(begin + length, testCase.selected(begin, end));
+            }
+        }
+    }
+}
+TEST_F(MyTest, TestNo261) { //TableCacheはArenaが上限を超えて追加しなかったテーブルを覚え、CSVが変わるまで通常の読み込みで読ませます。
+    auto &cache = TableCache::Instance();
+    cache.Clear();
+    cache.SetBudget(1024);
+    ofstream("PEOPLE.csv")
+        << "Id,Name,Pet" << endl
+        << "1,Carol,Rex" << endl
+        << "2,Alice,Tama" << endl
+        << "3,Bob,Pochi" << endl;
+    auto key = TableCache::Canonicalize("PEOPLE.csv"); // キャッシュのキーです。
+    struct stat status; // 入力ファイルの現在の情報です。
+
+    // データ行は上限に収まりますが、Arenaは最初の塊だけで上限を超えるので追加しません。
+    auto table = make_shared<CachedTable>();
+    table->arena.Allocate(1, 1);
+    EXPECT_FALSE(cache.Add("REJECTED", table));
+    EXPECT_EQ(0u, cache.Size());
+
+    // 一度読み込んで追加しなかったテーブルは、以降は絞り込みながら読み込みます。
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_EQ((int)OK, ExecuteSQL("SELECT Name WHERE Id >= 2 ORDER BY Name FROM PEOPLE", testOutputPath));
+        EXPECT_EQ("Name\nAlice\nBob\n", ReadOutput());
+        EXPECT_EQ(0u, cache.Size());
+        ASSERT_EQ(0, stat("PEOPLE.csv", &status));
+        EXPECT_TRUE(cache.IsRejected(key, status.st_size, status.st_mtim));
+    }
+
+    // 大きさの変わったCSVは、追加しなかったものとしては扱いません。
+    ofstream("PEOPLE.csv")
+        << "Id,Name,Pet" << endl
+        << "1,Carol,Rex" << endl;
+    ASSERT_EQ(0, stat("PEOPLE.csv", &status));
+    EXPECT_FALSE(cache.IsRejected(key, status.st_size, status.st_mtim));
+
+    // 上限を広げると、追加しなかったテーブルも再び追加できます。
+    ASSERT_EQ((int)OK, ExecuteSQL("SELECT Name FROM PEOPLE", testOutputPath));
+    EXPECT_TRUE(cache.IsRejected(key, status.st_size, status.st_mtim));
+    cache.SetBudget(64 << 20);
+    EXPECT_FALSE(cache.IsRejected(key, status.st_size, status.st_mtim));
+    ASSERT_EQ((int)OK, ExecuteSQL("SELECT Name FROM PEOPLE", testOutputPath));
+    EXPECT_EQ("Name\nCarol\n", ReadOutput());
+    EXPECT_EQ(1u, cache.Size());
+
+    cache.SetBudget(0);
+    cache.Clear();
+}
@@ -0,0 +1,75 @@
+#include <fstream>
+#include <string>
+#include <malloc.h>
+#include <gtest/gtest.h>
+
+#include "ExecuteSQL.hpp"
+#include "sqlQuery.hpp"
+#include "planCache.hpp"
+
+using namespace std;
+
+//! 大量のクエリを実行しても、確保されたままのメモリが増えないことを確かめます。
+class LeakTest : public ::testing::Test {
+protected:
+    const char *testOutputPath = "output.csv";
+
+    //! 解析するクエリです。WHERE句の式木、ORDER句、複数の列指定を含みます。
+    const string sql =
+        "SELECT Integer, String "
+        "WHERE (Integer >= 1 AND String <> 'B') OR -Integer * 2 < -4 "
+        "ORDER BY Integer DESC "
+        "FROM TABLE1";
+
+    //! 現在mallocから確保されたままのバイト数を取得します。
+    size_t AllocatedBytes()
+    {
+        return mallinfo2().uordblks;
+    }
+
+    virtual void SetUp() {
+        ofstream o("TABLE1.csv");
+        o
+            << "Integer,String" << endl
+            << "1,A" << endl
+            << "2,B" << endl
+            << "3,C" << endl;
+    };
+};
+
+TEST_F(LeakTest, TestNo1) { //SQLを百万回解析しても、確保されたままのメモリは増えません。
+    const int warmUp = 1000;
+    const int queries = 1000000;
+
+    // 構文情報のキャッシュに見つかると解析が行われないので、毎回キャッシュを空にしてから解析させます。
+    // 初回だけ確保される領域を先に確保させます。
+    for (int i = 0; i < warmUp; ++i) {
+        PlanCache::Instance().Clear();
+        SqlQuery query(sql);
+    }
+
+    auto before = AllocatedBytes();
+    for (int i = 0; i < queries; ++i) {
+        PlanCache::Instance().Clear();
+        SqlQuery query(sql);
+    }
+    auto after = AllocatedBytes();
+
+    EXPECT_EQ(before, after);
+}
+TEST_F(LeakTest, TestNo2) { //ExecuteSQLを繰り返し実行しても、確保されたままのメモリは増えません。
+    const int warmUp = 100;
+    const int queries = 10000;
+
+    for (int i = 0; i < warmUp; ++i) {
+        ASSERT_EQ(0, ExecuteSQL(sql, testOutputPath));
+    }
+
+    auto before = AllocatedBytes();
+    for (int i = 0; i < queries; ++i) {
+        ExecuteSQL(sql, testOutputPath);
+    }
+    auto after = AllocatedBytes();
+
+    EXPECT_EQ(before, after);
+}
@@ -19,7 +19,6 @@ Token::Token(const TokenKind kind) : Token(kind, "")
 //! Tokenクラスの新しいインスタンスを初期化します。
 //! @param [in] kind トークンの種類です。
 //! @param [in] word 記録されているトークンの文字列です。記録の必要がなければ空白です。
-Token::Token(const TokenKind kind, const string word) :kind(kind)
+Token::Token(const TokenKind kind, const string_view word) :kind(kind), word(word)
 {
-	this->word = word;
 }
@@ -1,13 +1,13 @@
 #pragma once
 
 #include "token_kind.hpp"
-#include <string>
+#include <string_view>
 
 //! トークンを表します。
 class Token {
 public:
 	TokenKind kind; //!< トークンの種類です。
-	std::string word; //!< 記録されているトークンの文字列です。記録の必要がなければ空白です。
+	std::string_view word; //!< 記録されているトークンの文字列です。記録の必要がなければ空白です。SQLの文字列を参照するので、SQLより長く使うことはできません。
 
 	//! Tokenクラスの新しいインスタンスを初期化します。
 	Token();
@@ -19,5 +19,5 @@ public:
 	//! Tokenクラスの新しいインスタンスを初期化します。
 	//! @param [in] kind トークンの種類です。
 	//! @param [in] word 記録されているトークンの文字列です。記録の必要がなければ空白です。
-	Token(const TokenKind kind, const std::string word);
+	Token(const TokenKind kind, const std::string_view word);
 };
\ No newline at end of file
@@ -31,5 +31,6 @@ enum class TokenKind
 	SLASH,                  //!< ／ 記号です。
 	IDENTIFIER,             //!< 識別子です。
 	INT_LITERAL,            //!< 整数リテラルです。
-	STRING_LITERAL          //!< 文字列リテラルです。
+	STRING_LITERAL,         //!< 文字列リテラルです。
+	PARAMETER               //!< ？ もしくは ：名前 で表すパラメータのプレースホルダーです。
 };
\ No newline at end of file
@@ -0,0 +1,505 @@
+#include "whereProgram.hpp"
+#include "batchKernel.hpp"
+#include "resultValue.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+//! WhereProgramクラスの新しいインスタンスを初期化します。
+//! @param [in] queryInfo 変換するWHERE句を含む構文情報です。
+//! @param [in] columnIndexes 各ノードに対応する列の、入力ファイルとしてのインデックスです。
+//! @param [in] inputTables ファイルから読み取ったデータです。
+//! @param [in] literals SQLに書かれたリテラルの値です。
+//! @param [in] parameters パラメータに設定された値です。
+//! @param [in] arena レジスタの領域を切り出すArenaです。
+//! @exception ResultValue 演算の左右の型が適切ではないか、式全体が真偽値とならない場合はERR_WHERE_OPERAND_TYPEです。
+WhereProgram::WhereProgram(const SqlQueryInfo &queryInfo, const vector<ColumnIndex> &columnIndexes,
+	const vector<InputTable> &inputTables, const vector<Data> &literals, const vector<Data> &parameters, Arena &arena) :
+	WhereProgram(queryInfo, queryInfo.whereTopNode < 0 ? vector<int>() : vector<int>{ queryInfo.whereTopNode },
+		inputTables.size() - 1, columnIndexes, inputTables, literals, parameters, arena)
+{
+}
+
+//! WHERE句の一部の条件の論理積を評価するWhereProgramクラスの新しいインスタンスを初期化します。
+//! @param [in] queryInfo 変換するWHERE句を含む構文情報です。
+//! @param [in] conjuncts 論理積をとる条件の、式木の根のノードのインデックスです。空の場合は全ての行が条件に合います。
+//! @param [in] batchTable 行をまとめて評価するテーブルのインデックスです。
+//! @param [in] columnIndexes 各ノードに対応する列の、入力ファイルとしてのインデックスです。条件に含まれるノードだけを使います。
+//! @param [in] inputTables ファイルから読み取ったデータです。条件に含まれる列だけを使います。
+//! @param [in] literals SQLに書かれたリテラルの値です。
+//! @param [in] parameters パラメータに設定された値です。
+//! @param [in] arena レジスタの領域を切り出すArenaです。
+//! @exception ResultValue 演算の左右の型が適切ではないか、条件が真偽値とならない場合はERR_WHERE_OPERAND_TYPEです。
+WhereProgram::WhereProgram(const SqlQueryInfo &queryInfo, const vector<int> &conjuncts, const int batchTable, const vector<ColumnIndex> &columnIndexes,
+	const vector<InputTable> &inputTables, const vector<Data> &literals, const vector<Data> &parameters, Arena &arena) :
+	integers(arena),
+	strings(arena),
+	booleans(arena),
+	inputTables(inputTables),
+	lastTable(batchTable)
+{
+	if (conjuncts.empty()){
+		return;
+	}
+	instructions.reserve(queryInfo.whereExtensionNodes.size() + conjuncts.size());
+
+	// 条件として使えるのは真偽値となる式だけです。二つ目以降の条件は、それまでの結果との論理積をとります。
+	for (auto conjunct : conjuncts) {
+		int conjunctResult; // 条件の結果を持つレジスタです。
+		if (Compile(conjunct, queryInfo, columnIndexes, inputTables, literals, parameters, conjunctResult) != DataType::BOOLEAN){
+			throw ResultValue::ERR_WHERE_OPERAND_TYPE;
+		}
+		if (0 <= result){
+			Release(DataType::BOOLEAN);
+			Release(DataType::BOOLEAN);
+			int left = result; // それまでの条件の論理積を持つレジスタです。
+			result = Allocate(DataType::BOOLEAN);
+			instructions.push_back({ OpCode::AND, result, left, conjunctResult, 0 });
+		}
+		else{
+			result = conjunctResult;
+		}
+	}
+	integers.resize(registerCounts[static_cast<int>(DataType::INTEGER)] * batchSize);
+	strings.resize(registerCounts[static_cast<int>(DataType::STRING)] * batchSize);
+	booleans.resize(registerCounts[static_cast<int>(DataType::BOOLEAN)] * batchSize);
+}
+
+//! WHERE句の式を、最上位のANDで区切った条件に分けます。
+//! @param [in] queryInfo 分けるWHERE句を含む構文情報です。
+//! @return 各条件の式木の根のノードのインデックスです。式に書かれた順に並びます。WHERE句がない場合は空です。
+vector<int> WhereProgram::SplitConjuncts(const SqlQueryInfo &queryInfo)
+{
+	vector<int> conjuncts;
+	if (queryInfo.whereTopNode < 0){
+		return conjuncts;
+	}
+	// ANDのノードは左右に分け、それ以外のノードは一つの条件とします。左から順に取り出すため、右を先にスタックに積みます。
+	vector<int> stack = { queryInfo.whereTopNode };
+	while (!stack.empty()){
+		auto node = stack.back();
+		stack.pop_back();
+		auto &treeNode = queryInfo.whereExtensionNodes[node];
+		if (treeNode.middleOperator.kind == TokenKind::AND){
+			stack.push_back(treeNode.right);
+			stack.push_back(treeNode.left);
+		}
+		else{
+			conjuncts.push_back(node);
+		}
+	}
+	return conjuncts;
+}
+
+//! 型のレジスタを一つ割り当てます。
+//! @param [in] type レジスタの型です。
+//! @return 割り当てたレジスタです。
+int WhereProgram::Allocate(const DataType type)
+{
+	auto index = static_cast<int>(type);
+	auto allocated = registerTops[index]++;
+	registerCounts[index] = max(registerCounts[index], registerTops[index]);
+	return allocated;
+}
+
+//! 最後に割り当てた型のレジスタを一つ解放します。
+//! @param [in] type レジスタの型です。
+void WhereProgram::Release(const DataType type)
+{
+	--registerTops[static_cast<int>(type)];
+}
+
+//! 式木のノード以下を命令に変換します。
+//! 帰りがけ順に、左右のオペランドの命令の後に演算の命令を並べます。再帰せずに変換するので、ORで長くつないだ条件のような深い式木でも、呼び出しのスタックは溢れません。
+//! @param [in] node 変換するノードのインデックスです。
+//! @param [in] queryInfo 変換するWHERE句を含む構文情報です。
+//! @param [in] columnIndexes 各ノードに対応する列の、入力ファイルとしてのインデックスです。
+//! @param [in] inputTables ファイルから読み取ったデータです。
+//! @param [in] literals SQLに書かれたリテラルの値です。
+//! @param [in] parameters パラメータに設定された値です。
+//! @param [out] destination ノードの式の値を持つレジスタです。
+//! @return ノードの式の型です。
+//! @exception ResultValue 演算の左右の型が適切ではないか、マイナスを前置したパラメータの値が文字列の場合はERR_WHERE_OPERAND_TYPEです。
+DataType WhereProgram::Compile(const int node, const SqlQueryInfo &queryInfo, const vector<ColumnIndex> &columnIndexes,
+	const vector<InputTable> &inputTables, const vector<Data> &literals, const vector<Data> &parameters, int &destination)
+{
+	vector<pair<int, bool>> nodes = { { node, false } }; // 変換していないノードと、左右のオペランドを変換し終えたかどうかです。
+	vector<pair<DataType, int>> operands; // 変換し終えて、まだ演算に使っていない式の型とレジスタです。
+	while (!nodes.empty()){
+		auto current = nodes.back().first; // 変換するノードです。
+		auto childrenCompiled = nodes.back().second; // 左右のオペランドを変換し終えたかどうかです。
+		nodes.pop_back();
+		auto &treeNode = queryInfo.whereExtensionNodes[current];
+
+		// 葉のノードは、列か定数を読み込む命令に変換します。
+		if (treeNode.middleOperator.kind == TokenKind::NOT_TOKEN){
+			int leaf; // 葉の値を持つレジスタです。
+			auto type = CompileLeaf(current, queryInfo, columnIndexes, inputTables, literals, parameters, leaf);
+			operands.push_back({ type, leaf });
+			continue;
+		}
+
+		// 番号で持つ文字列の列の比較は、文字列ではなく辞書順の番号を整数として比較します。
+		// それ以外は、左、右の順にオペランドを変換してから、もう一度取り出して演算の命令に変換します。
+		if (!childrenCompiled){
+			auto kind = treeNode.middleOperator.kind;
+			bool comparison = kind == TokenKind::EQUAL || kind == TokenKind::NOT_EQUAL ||
+				kind == TokenKind::GREATER_THAN || kind == TokenKind::GREATER_THAN_OR_EQUAL ||
+				kind == TokenKind::LESS_THAN || kind == TokenKind::LESS_THAN_OR_EQUAL; // 比較演算子かどうかです。
+			int left, right; // 左右のノードの番号を持つレジスタです。
+			if (!comparison || !CompileCodes(current, queryInfo, columnIndexes, literals, parameters, left, right)){
+				nodes.push_back({ current, true });
+				nodes.push_back({ treeNode.right, false });
+				nodes.push_back({ treeNode.left, false });
+				continue;
+			}
+			operands.push_back({ DataType::INTEGER, left });
+			operands.push_back({ DataType::INTEGER, right });
+		}
+		auto right = operands.back(); // 右のオペランドの型とレジスタです。
+		operands.pop_back();
+		auto left = operands.back(); // 左のオペランドの型とレジスタです。
+		operands.pop_back();
+		int computed; // 演算の結果を持つレジスタです。
+		auto type = CompileOperator(treeNode, left.first, left.second, right.first, right.second, computed);
+		operands.push_back({ type, computed });
+	}
+	destination = operands.back().second;
+	return operands.back().first;
+}
+
+//! 葉のノードを、列か定数を読み込む命令に変換します。
+//! @param [in] node 変換するノードのインデックスです。
+//! @param [in] queryInfo 変換するWHERE句を含む構文情報です。
+//! @param [in] columnIndexes 各ノードに対応する列の、入力ファイルとしてのインデックスです。
+//! @param [in] inputTables ファイルから読み取ったデータです。
+//! @param [in] literals SQLに書かれたリテラルの値です。
+//! @param [in] parameters パラメータに設定された値です。
+//! @param [out] destination ノードの値を持つレジスタです。
+//! @return ノードの値の型です。
+//! @exception ResultValue マイナスを前置したパラメータの値が文字列の場合はERR_WHERE_OPERAND_TYPEです。
+DataType WhereProgram::CompileLeaf(const int node, const SqlQueryInfo &queryInfo, const vector<ColumnIndex> &columnIndexes,
+	const vector<InputTable> &inputTables, const vector<Data> &literals, const vector<Data> &parameters, int &destination)
+{
+	auto &treeNode = queryInfo.whereExtensionNodes[node]; // 変換するノードです。
+	if (!treeNode.column.columnName.empty()){
+		auto &index = columnIndexes[node];
+		auto type = inputTables[index.table].Values(index.column).type;
+		destination = Allocate(type);
+		if (type == DataType::INTEGER){
+			instructions.push_back({ index.table == lastTable ? OpCode::LOAD_INT_COLUMN : OpCode::BROADCAST_INT_COLUMN,
+				destination, index.table, index.column, treeNode.signCoefficient });
+		}
+		else{
+			// 文字列の列に前置された符号は無視します。
+			instructions.push_back({ index.table == lastTable ? OpCode::LOAD_STRING_COLUMN : OpCode::BROADCAST_STRING_COLUMN,
+				destination, index.table, index.column, 0 });
+		}
+		return type;
+	}
+	auto &value = 0 <= treeNode.literalIndex ? literals[treeNode.literalIndex] : parameters[treeNode.parameterIndex];
+	// 文字列リテラルと同じく、マイナスを前置したパラメータの値が文字列であることは認めません。
+	if (value.type() == DataType::STRING && treeNode.signCoefficient == -1){
+		throw ResultValue::ERR_WHERE_OPERAND_TYPE;
+	}
+	destination = Allocate(value.type());
+	if (value.type() == DataType::INTEGER){
+		instructions.push_back({ OpCode::BROADCAST_INT, destination, 0, 0, value.integer() * treeNode.signCoefficient });
+	}
+	else{
+		stringConstants.push_back(value);
+		instructions.push_back({ OpCode::BROADCAST_STRING, destination, 0, 0, static_cast<int>(stringConstants.size()) - 1 });
+	}
+	return value.type();
+}
+
+//! 演算のノードを、左右のオペランドのレジスタから結果を求める命令に変換します。
+//! 左右のオペランドのレジスタを解放し、左のオペランドのあった位置から結果のレジスタを割り当てます。
+//! @param [in] treeNode 変換する演算のノードです。
+//! @param [in] leftType 左のオペランドの型です。
+//! @param [in] left 左のオペランドの値を持つレジスタです。
+//! @param [in] rightType 右のオペランドの型です。
+//! @param [in] right 右のオペランドの値を持つレジスタです。
+//! @param [out] destination 演算の結果を持つレジスタです。
+//! @return 演算の結果の型です。
+//! @exception ResultValue 演算の左右の型が適切ではない場合はERR_WHERE_OPERAND_TYPEです。
+DataType WhereProgram::CompileOperator(const ExtensionTreeNode &treeNode, const DataType leftType, const int left,
+	const DataType rightType, const int right, int &destination)
+{
+	Release(rightType);
+	Release(leftType);
+	auto emit = [&](const OpCode code, const DataType type) {
+		destination = Allocate(type);
+		instructions.push_back({ code, destination, left, right, 0 });
+		return type;
+	};
+
+	switch (treeNode.middleOperator.kind){
+	case TokenKind::EQUAL:
+	case TokenKind::GREATER_THAN:
+	case TokenKind::GREATER_THAN_OR_EQUAL:
+	case TokenKind::LESS_THAN:
+	case TokenKind::LESS_THAN_OR_EQUAL:
+	case TokenKind::NOT_EQUAL:
+		// 比較できるのは文字列型か整数型で、かつ左右の型が同じ場合です。
+		if ((leftType != DataType::INTEGER && leftType != DataType::STRING) || leftType != rightType){
+			throw ResultValue::ERR_WHERE_OPERAND_TYPE;
+		}
+		switch (treeNode.middleOperator.kind){
+		case TokenKind::EQUAL:
+			return emit(leftType == DataType::INTEGER ? OpCode::EQUAL_INT : OpCode::EQUAL_STRING, DataType::BOOLEAN);
+		case TokenKind::GREATER_THAN:
+			return emit(leftType == DataType::INTEGER ? OpCode::GREATER_THAN_INT : OpCode::GREATER_THAN_STRING, DataType::BOOLEAN);
+		case TokenKind::GREATER_THAN_OR_EQUAL:
+			return emit(leftType == DataType::INTEGER ? OpCode::GREATER_THAN_OR_EQUAL_INT : OpCode::GREATER_THAN_OR_EQUAL_STRING, DataType::BOOLEAN);
+		case TokenKind::LESS_THAN:
+			return emit(leftType == DataType::INTEGER ? OpCode::LESS_THAN_INT : OpCode::LESS_THAN_STRING, DataType::BOOLEAN);
+		case TokenKind::LESS_THAN_OR_EQUAL:
+			return emit(leftType == DataType::INTEGER ? OpCode::LESS_THAN_OR_EQUAL_INT : OpCode::LESS_THAN_OR_EQUAL_STRING, DataType::BOOLEAN);
+		default:
+			return emit(leftType == DataType::INTEGER ? OpCode::NOT_EQUAL_INT : OpCode::NOT_EQUAL_STRING, DataType::BOOLEAN);
+		}
+	case TokenKind::PLUS:
+	case TokenKind::MINUS:
+	case TokenKind::ASTERISK:
+	case TokenKind::SLASH:
+		// 演算できるのは整数型同士の場合のみです。
+		if (leftType != DataType::INTEGER || rightType != DataType::INTEGER){
+			throw ResultValue::ERR_WHERE_OPERAND_TYPE;
+		}
+		switch (treeNode.middleOperator.kind){
+		case TokenKind::PLUS:
+			return emit(OpCode::ADD, DataType::INTEGER);
+		case TokenKind::MINUS:
+			return emit(OpCode::SUBTRACT, DataType::INTEGER);
+		case TokenKind::ASTERISK:
+			return emit(OpCode::MULTIPLY, DataType::INTEGER);
+		default:
+			return emit(OpCode::DIVIDE, DataType::INTEGER);
+		}
+	default:
+		// 論理演算の場合です。演算できるのは真偽値型同士の場合のみです。
+		if (leftType != DataType::BOOLEAN || rightType != DataType::BOOLEAN){
+			throw ResultValue::ERR_WHERE_OPERAND_TYPE;
+		}
+		return emit(treeNode.middleOperator.kind == TokenKind::AND ? OpCode::AND : OpCode::OR, DataType::BOOLEAN);
+	}
+}
+
+//! 比較の左右のノードが、どちらもStringPoolの辞書順の番号で比較できる場合に、番号を読み込む命令に変換します。
+//! 番号で比較できるのは、同じプールの番号で持つ文字列の列と文字列の定数で、少なくとも一方が列の場合です。定数は比較の結果が変わらない番号に置き換えます。
+//! @param [in] node 変換する比較のノードのインデックスです。
+//! @param [in] queryInfo 変換するWHERE句を含む構文情報です。
+//! @param [in] columnIndexes 各ノードに対応する列の、入力ファイルとしてのインデックスです。
+//! @param [in] literals SQLに書かれたリテラルの値です。
+//! @param [in] parameters パラメータに設定された値です。
+//! @param [out] left 左のノードの番号を持つ整数のレジスタです。
+//! @param [out] right 右のノードの番号を持つ整数のレジスタです。
+//! @return 変換した場合はtrue、番号で比較できない場合は何もせずfalseです。
+bool WhereProgram::CompileCodes(const int node, const SqlQueryInfo &queryInfo, const vector<ColumnIndex> &columnIndexes,
+	const vector<Data> &literals, const vector<Data> &parameters, int &left, int &right)
+{
+	auto &treeNode = queryInfo.whereExtensionNodes[node];
+	const int operands[] = { treeNode.left, treeNode.right }; // 左右のノードのインデックスです。
+	const StringPool *pool = nullptr; // 列の値に番号を振ったプールです。
+	for (auto operand : operands) {
+		auto &operandNode = queryInfo.whereExtensionNodes[operand];
+		if (operandNode.middleOperator.kind != TokenKind::NOT_TOKEN){
+			return false;
+		}
+		if (!operandNode.column.columnName.empty()){
+			auto &column = inputTables[columnIndexes[operand].table].Values(columnIndexes[operand].column);
+			// TableCacheが保持するテーブルの列はテーブルごとの、サイドカーファイルから読み込んだ列は列ごとのプールで番号を振るので、異なるプールの番号同士は比較しません。
+			if (column.type != DataType::STRING || !column.pool || (pool && pool != column.pool)){
+				return false;
+			}
+			pool = column.pool;
+		}
+		else{
+			auto &value = 0 <= operandNode.literalIndex ? literals[operandNode.literalIndex] : parameters[operandNode.parameterIndex];
+			if (value.type() != DataType::STRING || operandNode.signCoefficient == -1){
+				return false;
+			}
+		}
+	}
+	if (!pool){
+		return false;
+	}
+
+	int *registers[] = { &left, &right }; // 左右のノードの番号を持つレジスタです。
+	for (int i = 0; i < 2; ++i) {
+		auto &operandNode = queryInfo.whereExtensionNodes[operands[i]];
+		*registers[i] = Allocate(DataType::INTEGER);
+		if (!operandNode.column.columnName.empty()){
+			auto &index = columnIndexes[operands[i]];
+			instructions.push_back({ index.table == lastTable ? OpCode::LOAD_CODE_COLUMN : OpCode::BROADCAST_CODE_COLUMN,
+				*registers[i], index.table, index.column, 0 });
+		}
+		else{
+			// 定数は、列の番号と比較した結果が値の比較と同じになる番号に置き換えます。
+			// 定数が左にある場合は、列から見た演算子に左右を入れ替えて考えます。
+			auto &value = 0 <= operandNode.literalIndex ? literals[operandNode.literalIndex] : parameters[operandNode.parameterIndex];
+			int position = pool->LowerBound(value.string()); // 定数以上となる最初の番号です。
+			int found = position < pool->Size() && pool->Cell(position).string() == value.string(); // 定数がプールにあれば1です。
+			auto kind = treeNode.middleOperator.kind; // 列から見た演算子です。
+			if (i == 0){
+				switch (kind){
+				case TokenKind::GREATER_THAN: kind = TokenKind::LESS_THAN; break;
+				case TokenKind::GREATER_THAN_OR_EQUAL: kind = TokenKind::LESS_THAN_OR_EQUAL; break;
+				case TokenKind::LESS_THAN: kind = TokenKind::GREATER_THAN; break;
+				case TokenKind::LESS_THAN_OR_EQUAL: kind = TokenKind::GREATER_THAN_OR_EQUAL; break;
+				default: break;
+				}
+			}
+			int code; // 定数を置き換えた番号です。
+			switch (kind){
+			case TokenKind::EQUAL:
+			case TokenKind::NOT_EQUAL:
+				// プールに無い文字列は、どの列の番号とも等しくならない-1とします。
+				code = found ? position : -1;
+				break;
+			case TokenKind::LESS_THAN:
+			case TokenKind::GREATER_THAN_OR_EQUAL:
+				// 列 < 定数 は 列 < 定数以上となる最初の番号、列 >= 定数 は 列 >= 定数以上となる最初の番号です。
+				code = position;
+				break;
+			default:
+				// 列 <= 定数 と 列 > 定数 は、定数以下となる最後の番号と比較します。
+				code = position + found - 1;
+				break;
+			}
+			instructions.push_back({ OpCode::BROADCAST_INT, *registers[i], 0, 0, code });
+		}
+	}
+	return true;
+}
+
+//! 最後のテーブルの連続した行と、他のテーブルの現在の行の組み合わせが、条件に合うかどうかをまとめて評価します。
+//! @param [in] currentRows 入力された各テーブルの、現在の行です。最後のテーブルは評価する最初の行です。
+//! @param [in] count 評価する最後のテーブルの行数です。batchSize以下です。
+//! @param [out] selection 条件に合った行の、currentRowsの最後のテーブルの行からの位置を、昇順に書き込みます。count個の領域が必要です。
+//! @return 条件に合った行の数です。
+int WhereProgram::Execute(const vector<int> &currentRows, const int count, int *selection)
+{
+	// WHERE句がなければ全ての行が条件に合います。
+	if (result < 0){
+		for (int i = 0; i < count; ++i) {
+			selection[i] = i;
+		}
+		return count;
+	}
+
+	auto integerRegister = [&](const int reg) { return &integers[reg * batchSize]; };  // 整数のレジスタの値の配列を取得します。
+	auto stringRegister = [&](const int reg) { return &strings[reg * batchSize]; };    // 文字列のレジスタの値の配列を取得します。
+	auto booleanRegister = [&](const int reg) { return &booleans[reg * batchSize]; };  // 真偽値のレジスタの値の配列を取得します。
+
+	// 文字列を比較します。
+	auto compareStrings = [&](const Instruction &instruction, auto compare) {
+		auto left = stringRegister(instruction.left);
+		auto right = stringRegister(instruction.right);
+		auto out = booleanRegister(instruction.destination);
+		for (int i = 0; i < count; ++i) {
+			out[i] = compare(left[i], right[i]);
+		}
+	};
+
+	for (auto &instruction : instructions) {
+		auto d = instruction.destination;
+		auto l = instruction.left;
+		auto r = instruction.right;
+		switch (instruction.code){
+		case OpCode::LOAD_INT_COLUMN: {
+			auto out = integerRegister(d);
+			auto values = inputTables[l].Values(r).Integers() + currentRows[l]; // 列の、評価する最初の行からの値です。
+			for (int i = 0; i < count; ++i) {
+				out[i] = values[i] * instruction.value;
+			}
+			break;
+		}
+		case OpCode::LOAD_STRING_COLUMN: {
+			auto out = stringRegister(d);
+			auto &column = inputTables[l].Values(r);
+			for (int i = 0; i < count; ++i) {
+				out[i] = column.Cell(currentRows[l] + i);
+			}
+			break;
+		}
+		case OpCode::BROADCAST_INT_COLUMN:
+			fill(integerRegister(d), integerRegister(d) + count, inputTables[l].Values(r).Integers()[currentRows[l]] * instruction.value);
+			break;
+		case OpCode::BROADCAST_STRING_COLUMN:
+			fill(stringRegister(d), stringRegister(d) + count, inputTables[l].Values(r).Cell(currentRows[l]));
+			break;
+		case OpCode::LOAD_CODE_COLUMN: {
+			auto codes = inputTables[l].Values(r).Codes() + currentRows[l]; // 列の、評価する最初の行からの番号です。
+			copy(codes, codes + count, integerRegister(d));
+			break;
+		}
+		case OpCode::BROADCAST_CODE_COLUMN:
+			fill(integerRegister(d), integerRegister(d) + count, inputTables[l].Values(r).Codes()[currentRows[l]]);
+			break;
+		case OpCode::BROADCAST_INT:
+			fill(integerRegister(d), integerRegister(d) + count, instruction.value);
+			break;
+		case OpCode::BROADCAST_STRING:
+			fill(stringRegister(d), stringRegister(d) + count, stringConstants[instruction.value]);
+			break;
+		case OpCode::EQUAL_INT:
+			BatchKernel::Equal(integerRegister(l), integerRegister(r), booleanRegister(d), count);
+			break;
+		case OpCode::NOT_EQUAL_INT:
+			BatchKernel::NotEqual(integerRegister(l), integerRegister(r), booleanRegister(d), count);
+			break;
+		case OpCode::GREATER_THAN_INT:
+			BatchKernel::GreaterThan(integerRegister(l), integerRegister(r), booleanRegister(d), count);
+			break;
+		case OpCode::GREATER_THAN_OR_EQUAL_INT:
+			BatchKernel::GreaterThanOrEqual(integerRegister(l), integerRegister(r), booleanRegister(d), count);
+			break;
+		case OpCode::LESS_THAN_INT:
+			BatchKernel::LessThan(integerRegister(l), integerRegister(r), booleanRegister(d), count);
+			break;
+		case OpCode::LESS_THAN_OR_EQUAL_INT:
+			BatchKernel::LessThanOrEqual(integerRegister(l), integerRegister(r), booleanRegister(d), count);
+			break;
+		case OpCode::EQUAL_STRING:
+			compareStrings(instruction, [](const Data &a, const Data &b) { return a.EqualString(b); });
+			break;
+		case OpCode::NOT_EQUAL_STRING:
+			compareStrings(instruction, [](const Data &a, const Data &b) { return !a.EqualString(b); });
+			break;
+		case OpCode::GREATER_THAN_STRING:
+			compareStrings(instruction, [](const Data &a, const Data &b) { return a.CompareString(b) > 0; });
+			break;
+		case OpCode::GREATER_THAN_OR_EQUAL_STRING:
+			compareStrings(instruction, [](const Data &a, const Data &b) { return a.CompareString(b) >= 0; });
+			break;
+		case OpCode::LESS_THAN_STRING:
+			compareStrings(instruction, [](const Data &a, const Data &b) { return a.CompareString(b) < 0; });
+			break;
+		case OpCode::LESS_THAN_OR_EQUAL_STRING:
+			compareStrings(instruction, [](const Data &a, const Data &b) { return a.CompareString(b) <= 0; });
+			break;
+		case OpCode::ADD:
+			BatchKernel::Add(integerRegister(l), integerRegister(r), integerRegister(d), count);
+			break;
+		case OpCode::SUBTRACT:
+			BatchKernel::Subtract(integerRegister(l), integerRegister(r), integerRegister(d), count);
+			break;
+		case OpCode::MULTIPLY:
+			BatchKernel::Multiply(integerRegister(l), integerRegister(r), integerRegister(d), count);
+			break;
+		case OpCode::DIVIDE:
+			BatchKernel::Divide(integerRegister(l), integerRegister(r), integerRegister(d), count);
+			break;
+		case OpCode::AND:
+			BatchKernel::And(booleanRegister(l), booleanRegister(r), booleanRegister(d), count);
+			break;
+		case OpCode::OR:
+			BatchKernel::Or(booleanRegister(l), booleanRegister(r), booleanRegister(d), count);
+			break;
+		}
+	}
+	return BatchKernel::Select(booleanRegister(result), count, selection);
+}
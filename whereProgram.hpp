@@ -0,0 +1,170 @@
+#pragma once
+
+#include "sqlQueryInfo.hpp"
+#include "column_index.hpp"
+#include "inputTable.hpp"
+#include "arena.hpp"
+#include "data.hpp"
+
+#include <string>
+#include <vector>
+
+//! WHERE句の式木を、型ごとのレジスタを使う一列の命令列に変換したものです。
+//! 型の検査は変換時に一度だけ行うので、評価時には型を調べません。列の値は、列ごとの連続した配列から読み込みます。
+//! 評価は一つのテーブルのbatchSize行ずつまとめて行い、各レジスタはその行数分の値の配列を持ちます。まとめて評価するテーブルは、WHERE句全体を評価する場合は最後のテーブルです。
+//! まとめて評価するテーブル以外の列と定数は、全ての行に同じ値を並べます。以下、命令の説明の「最後のテーブル」は、まとめて評価するテーブルを指します。
+class WhereProgram
+{
+public:
+	static constexpr int batchSize = 1024; //!< 一度にまとめて評価する行の数の上限です。
+
+private:
+	//! 命令の種類です。
+	enum class OpCode {
+		LOAD_INT_COLUMN,                 //!< 最後のテーブルの整数の列の値に、符号を掛けて読み込みます。
+		LOAD_STRING_COLUMN,              //!< 最後のテーブルの文字列の列の値を読み込みます。
+		BROADCAST_INT_COLUMN,            //!< 最後のテーブル以外の整数の列の値に、符号を掛けて全ての行に並べます。
+		BROADCAST_STRING_COLUMN,         //!< 最後のテーブル以外の文字列の列の値を全ての行に並べます。
+		LOAD_CODE_COLUMN,                //!< 最後のテーブルの、StringPoolの番号で持つ文字列の列の番号を整数として読み込みます。
+		BROADCAST_CODE_COLUMN,           //!< 最後のテーブル以外の、StringPoolの番号で持つ文字列の列の番号を全ての行に並べます。
+		BROADCAST_INT,                   //!< 整数の定数を全ての行に並べます。
+		BROADCAST_STRING,                //!< 文字列の定数を全ての行に並べます。
+		EQUAL_INT,                       //!< 整数を＝で比較します。
+		NOT_EQUAL_INT,                   //!< 整数を＜＞で比較します。
+		GREATER_THAN_INT,                //!< 整数を＞で比較します。
+		GREATER_THAN_OR_EQUAL_INT,       //!< 整数を＞＝で比較します。
+		LESS_THAN_INT,                   //!< 整数を＜で比較します。
+		LESS_THAN_OR_EQUAL_INT,          //!< 整数を＜＝で比較します。
+		EQUAL_STRING,                    //!< 文字列を＝で比較します。
+		NOT_EQUAL_STRING,                //!< 文字列を＜＞で比較します。
+		GREATER_THAN_STRING,             //!< 文字列を＞で比較します。
+		GREATER_THAN_OR_EQUAL_STRING,    //!< 文字列を＞＝で比較します。
+		LESS_THAN_STRING,                //!< 文字列を＜で比較します。
+		LESS_THAN_OR_EQUAL_STRING,       //!< 文字列を＜＝で比較します。
+		ADD,                             //!< 整数を足します。
+		SUBTRACT,                        //!< 整数を引きます。
+		MULTIPLY,                        //!< 整数を掛けます。
+		DIVIDE,                          //!< 整数を割ります。
+		AND,                             //!< 真偽値の論理積を求めます。
+		OR                               //!< 真偽値の論理和を求めます。
+	};
+
+	//! 一つの命令です。
+	struct Instruction {
+		OpCode code;      //!< 命令の種類です。
+		int destination;  //!< 結果を書き込むレジスタです。
+		int left;         //!< 左のオペランドのレジスタです。列を読み込む命令では、何テーブル目の列かです。
+		int right;        //!< 右のオペランドのレジスタです。列を読み込む命令では、テーブルの何列目かです。
+		int value;        //!< 整数の定数を並べる命令では、その値です。整数の列を読み込む命令では、掛ける符号です。文字列の定数を並べる命令では、stringConstantsのインデックスです。
+	};
+
+	std::vector<Instruction> instructions;   //!< 実行する順に並べた命令です。
+	ArenaVector<int> integers;               //!< 整数のレジスタです。batchSize個ずつの値を持ちます。
+	ArenaVector<Data> strings;               //!< 文字列のレジスタです。長い文字列の実体はコピーせず、列か定数の値を参照します。
+	ArenaVector<unsigned char> booleans;     //!< 真偽値のレジスタです。真は1、偽は0となります。
+	std::vector<Data> stringConstants;       //!< 文字列の定数です。長い文字列の実体は、SQLかパラメータの値が保持します。
+	const std::vector<InputTable> &inputTables; //!< ファイルから読み取ったデータです。
+	int lastTable = 0;                       //!< 行をまとめて評価するテーブルのインデックスです。
+	int registerTops[3] = {};                //!< 型ごとの、次に割り当てるレジスタです。レジスタは式木を帰りがけ順に評価する際のスタックとして割り当てます。
+	int registerCounts[3] = {};              //!< 型ごとの、同時に使うレジスタの数の最大値です。
+	int result = -1;                         //!< 式全体の結果を持つ真偽値のレジスタです。WHERE句がない場合は-1となります。
+
+	//! 式木のノード以下を命令に変換します。
+	//! 帰りがけ順に、左右のオペランドの命令の後に演算の命令を並べます。再帰せずに変換するので、ORで長くつないだ条件のような深い式木でも、呼び出しのスタックは溢れません。
+	//! @param [in] node 変換するノードのインデックスです。
+	//! @param [in] queryInfo 変換するWHERE句を含む構文情報です。
+	//! @param [in] columnIndexes 各ノードに対応する列の、入力ファイルとしてのインデックスです。
+	//! @param [in] inputTables ファイルから読み取ったデータです。
+	//! @param [in] literals SQLに書かれたリテラルの値です。
+	//! @param [in] parameters パラメータに設定された値です。
+	//! @param [out] destination ノードの式の値を持つレジスタです。
+	//! @return ノードの式の型です。
+	//! @exception ResultValue 演算の左右の型が適切ではないか、マイナスを前置したパラメータの値が文字列の場合はERR_WHERE_OPERAND_TYPEです。
+	DataType Compile(const int node, const SqlQueryInfo &queryInfo, const std::vector<ColumnIndex> &columnIndexes,
+		const std::vector<InputTable> &inputTables, const std::vector<Data> &literals, const std::vector<Data> &parameters, int &destination);
+
+	//! 葉のノードを、列か定数を読み込む命令に変換します。
+	//! @param [in] node 変換するノードのインデックスです。
+	//! @param [in] queryInfo 変換するWHERE句を含む構文情報です。
+	//! @param [in] columnIndexes 各ノードに対応する列の、入力ファイルとしてのインデックスです。
+	//! @param [in] inputTables ファイルから読み取ったデータです。
+	//! @param [in] literals SQLに書かれたリテラルの値です。
+	//! @param [in] parameters パラメータに設定された値です。
+	//! @param [out] destination ノードの値を持つレジスタです。
+	//! @return ノードの値の型です。
+	//! @exception ResultValue マイナスを前置したパラメータの値が文字列の場合はERR_WHERE_OPERAND_TYPEです。
+	DataType CompileLeaf(const int node, const SqlQueryInfo &queryInfo, const std::vector<ColumnIndex> &columnIndexes,
+		const std::vector<InputTable> &inputTables, const std::vector<Data> &literals, const std::vector<Data> &parameters, int &destination);
+
+	//! 演算のノードを、左右のオペランドのレジスタから結果を求める命令に変換します。
+	//! 左右のオペランドのレジスタを解放し、左のオペランドのあった位置から結果のレジスタを割り当てます。
+	//! @param [in] treeNode 変換する演算のノードです。
+	//! @param [in] leftType 左のオペランドの型です。
+	//! @param [in] left 左のオペランドの値を持つレジスタです。
+	//! @param [in] rightType 右のオペランドの型です。
+	//! @param [in] right 右のオペランドの値を持つレジスタです。
+	//! @param [out] destination 演算の結果を持つレジスタです。
+	//! @return 演算の結果の型です。
+	//! @exception ResultValue 演算の左右の型が適切ではない場合はERR_WHERE_OPERAND_TYPEです。
+	DataType CompileOperator(const ExtensionTreeNode &treeNode, const DataType leftType, const int left,
+		const DataType rightType, const int right, int &destination);
+
+	//! 比較の左右のノードが、どちらもStringPoolの辞書順の番号で比較できる場合に、番号を読み込む命令に変換します。
+	//! 番号で比較できるのは、同じプールの番号で持つ文字列の列と文字列の定数で、少なくとも一方が列の場合です。定数は比較の結果が変わらない番号に置き換えます。
+	//! @param [in] node 変換する比較のノードのインデックスです。
+	//! @param [in] queryInfo 変換するWHERE句を含む構文情報です。
+	//! @param [in] columnIndexes 各ノードに対応する列の、入力ファイルとしてのインデックスです。
+	//! @param [in] literals SQLに書かれたリテラルの値です。
+	//! @param [in] parameters パラメータに設定された値です。
+	//! @param [out] left 左のノードの番号を持つ整数のレジスタです。
+	//! @param [out] right 右のノードの番号を持つ整数のレジスタです。
+	//! @return 変換した場合はtrue、番号で比較できない場合は何もせずfalseです。
+	bool CompileCodes(const int node, const SqlQueryInfo &queryInfo, const std::vector<ColumnIndex> &columnIndexes,
+		const std::vector<Data> &literals, const std::vector<Data> &parameters, int &left, int &right);
+
+	//! 型のレジスタを一つ割り当てます。
+	//! @param [in] type レジスタの型です。
+	//! @return 割り当てたレジスタです。
+	int Allocate(const DataType type);
+
+	//! 最後に割り当てた型のレジスタを一つ解放します。
+	//! @param [in] type レジスタの型です。
+	void Release(const DataType type);
+
+public:
+	//! WhereProgramクラスの新しいインスタンスを初期化します。
+	//! @param [in] queryInfo 変換するWHERE句を含む構文情報です。
+	//! @param [in] columnIndexes 各ノードに対応する列の、入力ファイルとしてのインデックスです。
+	//! @param [in] inputTables ファイルから読み取ったデータです。
+	//! @param [in] literals SQLに書かれたリテラルの値です。
+	//! @param [in] parameters パラメータに設定された値です。
+	//! @param [in] arena レジスタの領域を切り出すArenaです。
+	//! @exception ResultValue 演算の左右の型が適切ではないか、式全体が真偽値とならない場合はERR_WHERE_OPERAND_TYPEです。
+	WhereProgram(const SqlQueryInfo &queryInfo, const std::vector<ColumnIndex> &columnIndexes,
+		const std::vector<InputTable> &inputTables, const std::vector<Data> &literals, const std::vector<Data> &parameters, Arena &arena);
+
+	//! WHERE句の一部の条件の論理積を評価するWhereProgramクラスの新しいインスタンスを初期化します。
+	//! @param [in] queryInfo 変換するWHERE句を含む構文情報です。
+	//! @param [in] conjuncts 論理積をとる条件の、式木の根のノードのインデックスです。空の場合は全ての行が条件に合います。
+	//! @param [in] batchTable 行をまとめて評価するテーブルのインデックスです。
+	//! @param [in] columnIndexes 各ノードに対応する列の、入力ファイルとしてのインデックスです。条件に含まれるノードだけを使います。
+	//! @param [in] inputTables ファイルから読み取ったデータです。条件に含まれる列だけを使います。
+	//! @param [in] literals SQLに書かれたリテラルの値です。
+	//! @param [in] parameters パラメータに設定された値です。
+	//! @param [in] arena レジスタの領域を切り出すArenaです。
+	//! @exception ResultValue 演算の左右の型が適切ではないか、条件が真偽値とならない場合はERR_WHERE_OPERAND_TYPEです。
+	WhereProgram(const SqlQueryInfo &queryInfo, const std::vector<int> &conjuncts, const int batchTable, const std::vector<ColumnIndex> &columnIndexes,
+		const std::vector<InputTable> &inputTables, const std::vector<Data> &literals, const std::vector<Data> &parameters, Arena &arena);
+
+	//! WHERE句の式を、最上位のANDで区切った条件に分けます。
+	//! @param [in] queryInfo 分けるWHERE句を含む構文情報です。
+	//! @return 各条件の式木の根のノードのインデックスです。式に書かれた順に並びます。WHERE句がない場合は空です。
+	static std::vector<int> SplitConjuncts(const SqlQueryInfo &queryInfo);
+
+	//! 最後のテーブルの連続した行と、他のテーブルの現在の行の組み合わせが、条件に合うかどうかをまとめて評価します。
+	//! @param [in] currentRows 入力された各テーブルの、現在の行です。最後のテーブルは評価する最初の行です。
+	//! @param [in] count 評価する最後のテーブルの行数です。batchSize以下です。
+	//! @param [out] selection 条件に合った行の、currentRowsの最後のテーブルの行からの位置を、昇順に書き込みます。count個の領域が必要です。
+	//! @return 条件に合った行の数です。
+	int Execute(const std::vector<int> &currentRows, const int count, int *selection);
+};